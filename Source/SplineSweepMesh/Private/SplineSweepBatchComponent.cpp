@@ -0,0 +1,333 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepBatchComponent.h"
+#include "SplineSweepMeshComponent.h"
+#include "SplineSweepProfileCache.h"
+#include "SplineSweepStats.h"
+
+USplineSweepBatchComponent::USplineSweepBatchComponent()
+{
+	//Ticks only to upload changes once per frame
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+	bTickInEditor = true;
+}
+
+void USplineSweepBatchComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	FlushSweeps();
+}
+
+int USplineSweepBatchComponent::AddSweep(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, UMaterialInterface* SideMaterial, UMaterialInterface* CoverMaterial)
+{
+	SPLINESWEEP_SCOPE(CreateSweepMesh);
+	if (!SweepSpline || !PathSpline)
+	{
+		return INDEX_NONE;
+	}
+
+	const int Handle = NextHandle++;
+	FSweep& Sweep = Sweeps.Add(Handle);
+	Sweep.Path = PathSpline;
+	Sweep.PathToBatch = GetPathToBatch(PathSpline);
+	Sweep.Settings.NumSegments = segments;
+	Sweep.Settings.bSmoothNormal = SmoothNormal;
+	//If is not closed loop,create covers
+	Sweep.Settings.bHaveCover = !PathSpline->IsClosedLoop();
+	Sweep.Settings.bCreateCollision = bCreateCollision;
+	TArray<FVector> ProfilePoints;
+	TArray<FVector> ProfileNormals;
+	USplineSweepMeshComponent::TessellateSplinePoints(SweepSpline, MaxProfileDeviation, ProfilePoints, ProfileNormals);
+	Sweep.Profile = FSplineSweepProfileCache::Get().FindOrCreate(ProfilePoints, ProfileNormals, Sweep.Settings.bHaveCover);
+
+	FSplineSweepPathSnapshot Snapshot;
+	Snapshot.Capture(PathSpline);
+	TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+	NewFrames->Build(Snapshot, FrameCacheSamplesPerSegment);
+	Sweep.Frames = NewFrames;
+	FSplineSweepGenerator(*Sweep.Profile, *Sweep.Frames, Sweep.Settings).Build(Rate, Sweep.Buffers, true);
+
+	Sweep.SideSection = FindOrAddSection(SideMaterial);
+	AppendPart(Sweep.SideSection, Handle, false);
+	if (Sweep.Settings.bHaveCover)
+	{
+		Sweep.CoverSection = FindOrAddSection(CoverMaterial);
+		AppendPart(Sweep.CoverSection, Handle, true);
+	}
+	return Handle;
+}
+
+void USplineSweepBatchComponent::UpdateSweep(int Handle, USplineComponent* Path, float Rate)
+{
+	SPLINESWEEP_SCOPE(UpdatePathSpline);
+	FSweep* Sweep = Sweeps.Find(Handle);
+	if (!Sweep || !Path)
+	{
+		return;
+	}
+
+	Sweep->Path = Path;
+	Sweep->PathToBatch = GetPathToBatch(Path);
+	if (!Sweep->Frames->IsUpToDate(Path, FrameCacheSamplesPerSegment))
+	{
+		FSplineSweepPathSnapshot Snapshot;
+		Snapshot.Capture(Path);
+		TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+		NewFrames->Build(Snapshot, FrameCacheSamplesPerSegment);
+		Sweep->Frames = NewFrames;
+	}
+	FSplineSweepGenerator(*Sweep->Profile, *Sweep->Frames, Sweep->Settings).Build(Rate, Sweep->Buffers, false);
+
+	//Rewrite ranges in place,a range that changed size moves every range after it
+	for (int SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
+	{
+		FSection& Section = Sections[SectionIndex];
+		if (SectionIndex != Sweep->SideSection && SectionIndex != Sweep->CoverSection)
+		{
+			continue;
+		}
+		for (const FPart& Part : Section.Parts)
+		{
+			if (Part.Handle != Handle)
+			{
+				continue;
+			}
+			const TArray<FVector>* Vertices;
+			const TArray<FVector>* Normals;
+			const TArray<FVector2D>* UVs;
+			const TArray<FProcMeshTangent>* Tangents;
+			const TArray<int>* Indices;
+			GetPartGeometry(*Sweep, Part.bCover, Vertices, Normals, UVs, Tangents, Indices);
+			if (Vertices->Num() == Part.NumVertices && Indices->Num() == Part.NumIndices)
+			{
+				WritePart(Section, Part);
+				MarkSection(SectionIndex, ESectionChange::Update);
+			}
+			else
+			{
+				MarkSection(SectionIndex, ESectionChange::Repack);
+			}
+		}
+	}
+}
+
+void USplineSweepBatchComponent::RemoveSweep(int Handle)
+{
+	FSweep Sweep;
+	if (!Sweeps.RemoveAndCopyValue(Handle, Sweep))
+	{
+		return;
+	}
+	const int SectionIndices[] = { Sweep.SideSection, Sweep.CoverSection };
+	for (int SectionIndex : SectionIndices)
+	{
+		if (Sections.IsValidIndex(SectionIndex))
+		{
+			Sections[SectionIndex].Parts.RemoveAll([Handle](const FPart& Part) { return Part.Handle == Handle; });
+			MarkSection(SectionIndex, ESectionChange::Repack);
+		}
+	}
+}
+
+void USplineSweepBatchComponent::ClearSweeps()
+{
+	Sweeps.Reset();
+	Sections.Reset();
+	ClearAllMeshSections();
+	SetComponentTickEnabled(false);
+}
+
+void USplineSweepBatchComponent::FlushSweeps()
+{
+	for (int SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
+	{
+		FSection& Section = Sections[SectionIndex];
+		if (Section.Change != ESectionChange::None && Section.Parts.Num() == 0)
+		{
+			//Keep index of section for its material,only drop geometry
+			Section.Change = ESectionChange::None;
+			Section.Vertices.Empty();
+			Section.Normals.Empty();
+			Section.UVs.Empty();
+			Section.Tangents.Empty();
+			Section.Indices.Empty();
+			ClearMeshSection(SectionIndex);
+			continue;
+		}
+		switch (Section.Change)
+		{
+		case ESectionChange::Repack:
+			//Topology changed,create the section
+			RepackSection(Section);
+			CreatePackedSection(SectionIndex);
+			break;
+		case ESectionChange::Create:
+			CreatePackedSection(SectionIndex);
+			break;
+		case ESectionChange::Update:
+		{
+			//Procedural mesh uploads whole sections,only CPU side work is limited to changed ranges
+			SPLINESWEEP_SCOPE(UpdateMeshSection);
+			UpdateMeshSection(SectionIndex, Section.Vertices, Section.Normals, Section.UVs, EmptyColors, Section.Tangents);
+			break;
+		}
+		default:
+			break;
+		}
+		Section.Change = ESectionChange::None;
+	}
+	SetComponentTickEnabled(false);
+}
+
+void USplineSweepBatchComponent::CreatePackedSection(int SectionIndex)
+{
+	SPLINESWEEP_SCOPE(CreateMeshSection);
+	const FSection& Section = Sections[SectionIndex];
+	CreateMeshSection(SectionIndex, Section.Vertices, Section.Indices, Section.Normals, Section.UVs, EmptyColors, Section.Tangents, bCreateCollision);
+	SetMaterial(SectionIndex, Section.Material.Get());
+}
+
+int USplineSweepBatchComponent::FindOrAddSection(UMaterialInterface* Material)
+{
+	for (int SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
+	{
+		if (Sections[SectionIndex].Material.Get() == Material)
+		{
+			return SectionIndex;
+		}
+	}
+	const int SectionIndex = Sections.AddDefaulted();
+	Sections[SectionIndex].Material = Material;
+	return SectionIndex;
+}
+
+void USplineSweepBatchComponent::AppendPart(int SectionIndex, int Handle, bool bCover)
+{
+	FSection& Section = Sections[SectionIndex];
+	const TArray<FVector>* Vertices;
+	const TArray<FVector>* Normals;
+	const TArray<FVector2D>* UVs;
+	const TArray<FProcMeshTangent>* Tangents;
+	const TArray<int>* Indices;
+	GetPartGeometry(Sweeps[Handle], bCover, Vertices, Normals, UVs, Tangents, Indices);
+
+	FPart& Part = Section.Parts.AddDefaulted_GetRef();
+	Part.Handle = Handle;
+	Part.bCover = bCover;
+	Part.FirstVertex = Section.Vertices.Num();
+	Part.NumVertices = Vertices->Num();
+	Part.FirstIndex = Section.Indices.Num();
+	Part.NumIndices = Indices->Num();
+
+	Section.Vertices.AddUninitialized(Part.NumVertices);
+	Section.Normals.AddUninitialized(Part.NumVertices);
+	Section.UVs.AddUninitialized(Part.NumVertices);
+	Section.Tangents.AddUninitialized(Part.NumVertices);
+	Section.Indices.AddUninitialized(Part.NumIndices);
+	WritePart(Section, Part);
+	MarkSection(SectionIndex, ESectionChange::Create);
+}
+
+void USplineSweepBatchComponent::WritePart(FSection& Section, const FPart& Part) const
+{
+	const TArray<FVector>* Vertices;
+	const TArray<FVector>* Normals;
+	const TArray<FVector2D>* UVs;
+	const TArray<FProcMeshTangent>* Tangents;
+	const TArray<int>* Indices;
+	const FSweep& Sweep = Sweeps[Part.Handle];
+	GetPartGeometry(Sweep, Part.bCover, Vertices, Normals, UVs, Tangents, Indices);
+
+	const FTransform& PathToBatch = Sweep.PathToBatch;
+	const bool bSameSpace = PathToBatch.Equals(FTransform::Identity);
+	if (bSameSpace)
+	{
+		FMemory::Memcpy(&Section.Vertices[Part.FirstVertex], Vertices->GetData(), Part.NumVertices * sizeof(FVector));
+		FMemory::Memcpy(&Section.Normals[Part.FirstVertex], Normals->GetData(), Part.NumVertices * sizeof(FVector));
+	}
+	else
+	{
+		//Normals are scaled inversely,so they stay perpendicular to surfaces of non uniformly scaled paths
+		const FVector InvScale = PathToBatch.GetSafeScaleReciprocal(PathToBatch.GetScale3D());
+		for (int i = 0; i < Part.NumVertices; i++)
+		{
+			Section.Vertices[Part.FirstVertex + i] = PathToBatch.TransformPosition((*Vertices)[i]);
+			Section.Normals[Part.FirstVertex + i] = PathToBatch.TransformVectorNoScale((*Normals)[i] * InvScale).GetSafeNormal();
+		}
+	}
+	if (UVs)
+	{
+		FMemory::Memcpy(&Section.UVs[Part.FirstVertex], UVs->GetData(), Part.NumVertices * sizeof(FVector2D));
+	}
+	else
+	{
+		//Covers have no UVs
+		FMemory::Memzero(&Section.UVs[Part.FirstVertex], Part.NumVertices * sizeof(FVector2D));
+	}
+	for (int i = 0; i < Part.NumVertices; i++)
+	{
+		FProcMeshTangent Tangent = Tangents->IsValidIndex(i) ? (*Tangents)[i] : FProcMeshTangent();
+		if (!bSameSpace)
+		{
+			Tangent.TangentX = PathToBatch.TransformVector(Tangent.TangentX).GetSafeNormal();
+		}
+		Section.Tangents[Part.FirstVertex + i] = Tangent;
+	}
+	for (int i = 0; i < Part.NumIndices; i++)
+	{
+		Section.Indices[Part.FirstIndex + i] = Part.FirstVertex + (*Indices)[i];
+	}
+}
+
+void USplineSweepBatchComponent::RepackSection(FSection& Section)
+{
+	Section.Vertices.Reset();
+	Section.Normals.Reset();
+	Section.UVs.Reset();
+	Section.Tangents.Reset();
+	Section.Indices.Reset();
+	for (FPart& Part : Section.Parts)
+	{
+		const TArray<FVector>* Vertices;
+		const TArray<FVector>* Normals;
+		const TArray<FVector2D>* UVs;
+		const TArray<FProcMeshTangent>* Tangents;
+		const TArray<int>* Indices;
+		GetPartGeometry(Sweeps[Part.Handle], Part.bCover, Vertices, Normals, UVs, Tangents, Indices);
+
+		Part.FirstVertex = Section.Vertices.Num();
+		Part.NumVertices = Vertices->Num();
+		Part.FirstIndex = Section.Indices.Num();
+		Part.NumIndices = Indices->Num();
+		Section.Vertices.AddUninitialized(Part.NumVertices);
+		Section.Normals.AddUninitialized(Part.NumVertices);
+		Section.UVs.AddUninitialized(Part.NumVertices);
+		Section.Tangents.AddUninitialized(Part.NumVertices);
+		Section.Indices.AddUninitialized(Part.NumIndices);
+		WritePart(Section, Part);
+	}
+}
+
+void USplineSweepBatchComponent::GetPartGeometry(const FSweep& Sweep, bool bCover, const TArray<FVector>*& OutVertices, const TArray<FVector>*& OutNormals, const TArray<FVector2D>*& OutUVs, const TArray<FProcMeshTangent>*& OutTangents, const TArray<int>*& OutIndices) const
+{
+	const FSplineSweepMeshBuffers& Buffers = Sweep.Buffers;
+	OutVertices = bCover ? &Buffers.CoverVertices : &Buffers.SideVertices;
+	OutNormals = bCover ? &Buffers.CoverNormals : &Buffers.SideNormals;
+	OutUVs = bCover ? nullptr : &Buffers.SideUVs;
+	OutTangents = bCover ? &Buffers.CoverTangents : &Buffers.SideTangents;
+	OutIndices = bCover ? &Buffers.CoverIndices : &Buffers.SideIndices;
+}
+
+FTransform USplineSweepBatchComponent::GetPathToBatch(USplineComponent* Path) const
+{
+	return Path->GetComponentTransform().GetRelativeTransform(GetComponentTransform());
+}
+
+void USplineSweepBatchComponent::MarkSection(int SectionIndex, ESectionChange Change)
+{
+	FSection& Section = Sections[SectionIndex];
+	Section.Change = FMath::Max(Section.Change, Change);
+	SetComponentTickEnabled(true);
+}
@@ -0,0 +1,417 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepBenchmarkCommandlet.h"
+#include "SplineSweepProfile.h"
+#include "SplineSweepTriangulator.h"
+#include "SplineSweepMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/MemoryBase.h"
+#include "Interfaces/IPluginManager.h"
+#include "Misc/App.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogSplineSweepBenchmark, Log, All);
+
+namespace SplineSweepBenchmark
+{
+	//Forwards to the engine allocator and counts allocations while enabled.Installed once and never removed,blocks may be freed through it later
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Size, Alignment);
+		}
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			//Growing or shrinking a block may move it,freeing is not an allocation
+			if (Size > 0)
+			{
+				CountAllocation();
+			}
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptor() const override { return Inner->GetDescriptor(); }
+
+		//Start counting from zero.Allocations of every thread are counted,including workers of ParallelFor
+		void Begin()
+		{
+			NumAllocations.Reset();
+			bCounting = true;
+		}
+		int64 End()
+		{
+			bCounting = false;
+			return NumAllocations.GetValue();
+		}
+
+	private:
+		void CountAllocation()
+		{
+			if (bCounting)
+			{
+				NumAllocations.Increment();
+			}
+		}
+
+		FMalloc* Inner;
+		FThreadSafeCounter64 NumAllocations;
+		volatile bool bCounting = false;
+	};
+
+	static FCountingMalloc* GetCountingMalloc()
+	{
+		static FCountingMalloc* CountingMalloc = nullptr;
+		if (!CountingMalloc)
+		{
+			CountingMalloc = new FCountingMalloc(GMalloc);
+			GMalloc = CountingMalloc;
+		}
+		return CountingMalloc;
+	}
+
+	//Wall time and allocations of one call,best and mean over iterations
+	struct FCallTiming
+	{
+		double BestSeconds = MAX_dbl;
+		double TotalSeconds = 0;
+		int64 TotalAllocations = 0;
+		int NumCalls = 0;
+
+		void Add(double Seconds, int64 Allocations)
+		{
+			BestSeconds = FMath::Min(BestSeconds, Seconds);
+			TotalSeconds += Seconds;
+			TotalAllocations += Allocations;
+			NumCalls++;
+		}
+		double GetMeanSeconds() const { return NumCalls > 0 ? TotalSeconds / NumCalls : 0; }
+		double GetAllocationsPerCall() const { return NumCalls > 0 ? double(TotalAllocations) / NumCalls : 0; }
+
+		void Write(const FString& Prefix, int NumTriangles, FJsonObject& Out) const
+		{
+			Out.SetNumberField(Prefix + TEXT("BestMs"), BestSeconds * 1000);
+			Out.SetNumberField(Prefix + TEXT("MeanMs"), GetMeanSeconds() * 1000);
+			Out.SetNumberField(Prefix + TEXT("TrianglesPerSecond"), NumTriangles / FMath::Max(BestSeconds, 1e-9));
+			Out.SetNumberField(Prefix + TEXT("AllocationsPerCall"), GetAllocationsPerCall());
+		}
+	};
+
+	//Closed circle of linear spline points in YZ plane,used as profile to sweep
+	static void MakeProfileSpline(int NumPoints, float Radius, USplineComponent* OutSpline)
+	{
+		OutSpline->ClearSplinePoints(false);
+		OutSpline->SetClosedLoop(true, false);
+		for (int i = 0; i < NumPoints; i++)
+		{
+			const float Angle = 2 * PI * i / NumPoints;
+			OutSpline->AddSplinePoint(FVector(0, FMath::Cos(Angle), FMath::Sin(Angle)) * Radius, ESplineCoordinateSpace::Local, false);
+			OutSpline->SetSplinePointType(i, ESplinePointType::Linear, false);
+		}
+		OutSpline->UpdateSpline();
+	}
+
+	//Winding path like a road,rising slowly,8 curve points whatever its length
+	static void MakePathSpline(float Length, USplineComponent* OutSpline)
+	{
+		const int NumPoints = 8;
+		OutSpline->ClearSplinePoints(false);
+		OutSpline->SetClosedLoop(false, false);
+		for (int i = 0; i < NumPoints; i++)
+		{
+			const float Alpha = float(i) / (NumPoints - 1);
+			OutSpline->AddSplinePoint(FVector(Alpha * Length, FMath::Sin(Alpha * 3 * PI) * Length * 0.1f, Alpha * Length * 0.02f), ESplineCoordinateSpace::Local, false);
+		}
+		OutSpline->UpdateSpline();
+	}
+
+	static int GetNumTriangles(USplineSweepMeshComponent* Component)
+	{
+		int NumIndices = 0;
+		for (int Section = 0; Section < Component->GetNumSections(); Section++)
+		{
+			if (FProcMeshSection* MeshSection = Component->GetProcMeshSection(Section))
+			{
+				NumIndices += MeshSection->ProcIndexBuffer.Num();
+			}
+		}
+		return NumIndices / 3;
+	}
+
+	//Circle profile in YZ plane,normals point outward like GetSplinePointsNormal
+	static void MakeCircleProfile(int NumPoints, float Radius, FSplineSweepProfile& OutProfile)
+	{
+		TArray<FVector> Points;
+		TArray<FVector> Normals;
+		for (int i = 0; i < NumPoints; i++)
+		{
+			const float Angle = 2 * PI * i / NumPoints;
+			Points.Add(FVector(0, FMath::Cos(Angle), FMath::Sin(Angle)) * Radius);
+			Normals.Add(FVector(0, FMath::Cos(Angle), FMath::Sin(Angle)));
+		}
+		OutProfile.SetPoints(Points, Normals);
+	}
+
+	//Star outline in YZ plane,every second point is reflex
+	static void MakeStarOutline(int NumPoints, float Radius, TArray<FVector>& OutPoints)
+	{
+		OutPoints.Reset(NumPoints);
+		for (int i = 0; i < NumPoints; i++)
+		{
+			const float Angle = -2 * PI * i / NumPoints;
+			const float R = (i % 2 == 0) ? Radius : Radius * 0.6f;
+			OutPoints.Add(FVector(0, FMath::Cos(Angle), FMath::Sin(Angle)) * R);
+		}
+	}
+
+	//Frames along a gently curving path with non uniform scale
+	static FMatrix MakeFrame(int Ring)
+	{
+		const FQuat Rotation(FVector::UpVector, Ring * 0.01f);
+		const FVector Scale(1, 1 + Ring * 0.001f, 1 - Ring * 0.0005f);
+		return FScaleMatrix(Scale) * FQuatRotationTranslationMatrix(Rotation, FVector(Ring * 10.0f, 0, 0));
+	}
+}
+
+USplineSweepBenchmarkCommandlet::USplineSweepBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 USplineSweepBenchmarkCommandlet::Main(const FString& Params)
+{
+	int Iterations = 5;
+	FParse::Value(*Params, TEXT("iterations="), Iterations);
+	Iterations = FMath::Max(Iterations, 1);
+	const bool bQuick = FParse::Param(*Params, TEXT("quick"));
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("output="), OutputPath))
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("SplineSweepBenchmark") / FString::Printf(TEXT("Results-%s.json"), *FDateTime::Now().ToString());
+	}
+
+	TArray<TSharedPtr<FJsonValue>> Results;
+	BenchmarkRingTransform(Iterations, Results);
+	BenchmarkTriangulation(Iterations, Results);
+	BenchmarkSweep(Iterations, bQuick, Results);
+	return WriteResults(OutputPath, Iterations, Results) ? 0 : 1;
+}
+
+void USplineSweepBenchmarkCommandlet::BenchmarkRingTransform(int Iterations, TArray<TSharedPtr<FJsonValue>>& OutResults)
+{
+	const int NumRings = 2000;
+	const int ProfileSizes[] = { 4, 16, 64, 128 };
+
+	for (int NumPoints : ProfileSizes)
+	{
+		FSplineSweepProfile Profile;
+		SplineSweepBenchmark::MakeCircleProfile(NumPoints, 50, Profile);
+
+		TArray<FMatrix> Frames;
+		for (int i = 0; i < NumRings; i++)
+		{
+			Frames.Add(SplineSweepBenchmark::MakeFrame(i));
+		}
+		TArray<FVector> Points;
+		TArray<FVector> Normals;
+		Points.SetNumUninitialized(NumRings * NumPoints);
+		Normals.SetNumUninitialized(NumRings * NumPoints);
+
+		//Best of all iterations,to keep noise from other processes out
+		double ScalarSeconds = MAX_dbl;
+		double VectorSeconds = MAX_dbl;
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			double Start = FPlatformTime::Seconds();
+			for (int i = 0; i < NumRings; i++)
+			{
+				Profile.TransformRingScalar(Frames[i], &Points[i * NumPoints], &Normals[i * NumPoints]);
+			}
+			ScalarSeconds = FMath::Min(ScalarSeconds, FPlatformTime::Seconds() - Start);
+
+			Start = FPlatformTime::Seconds();
+			for (int i = 0; i < NumRings; i++)
+			{
+				Profile.TransformRing(Frames[i], &Points[i * NumPoints], &Normals[i * NumPoints]);
+			}
+			VectorSeconds = FMath::Min(VectorSeconds, FPlatformTime::Seconds() - Start);
+		}
+
+		const double NumTransformed = double(NumRings) * NumPoints;
+		UE_LOG(LogSplineSweepBenchmark, Display, TEXT("RingTransform profile=%d rings=%d scalar=%.1f Mpts/s vector=%.1f Mpts/s speedup=%.2fx"),
+			NumPoints, NumRings,
+			NumTransformed / FMath::Max(ScalarSeconds, 1e-9) / 1e6,
+			NumTransformed / FMath::Max(VectorSeconds, 1e-9) / 1e6,
+			ScalarSeconds / FMath::Max(VectorSeconds, 1e-9));
+
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetStringField(TEXT("Benchmark"), TEXT("RingTransform"));
+		Result->SetNumberField(TEXT("ProfilePoints"), NumPoints);
+		Result->SetNumberField(TEXT("Rings"), NumRings);
+		Result->SetNumberField(TEXT("ScalarMs"), ScalarSeconds * 1000);
+		Result->SetNumberField(TEXT("VectorMs"), VectorSeconds * 1000);
+		OutResults.Add(MakeShared<FJsonValueObject>(Result));
+	}
+}
+
+void USplineSweepBenchmarkCommandlet::BenchmarkTriangulation(int Iterations, TArray<TSharedPtr<FJsonValue>>& OutResults)
+{
+	const int OutlineSizes[] = { 10, 100, 1000, 10000 };
+
+	for (int NumPoints : OutlineSizes)
+	{
+		TArray<FVector> Outline;
+		SplineSweepBenchmark::MakeStarOutline(NumPoints, 50, Outline);
+
+		TArray<int> Indices;
+		double Seconds = MAX_dbl;
+		int NumTriangles = 0;
+		for (int Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			const double Start = FPlatformTime::Seconds();
+			NumTriangles = FSplineSweepTriangulator::Triangulate(Outline, Indices);
+			Seconds = FMath::Min(Seconds, FPlatformTime::Seconds() - Start);
+		}
+
+		UE_LOG(LogSplineSweepBenchmark, Display, TEXT("Triangulate points=%d triangles=%d time=%.3f ms"),
+			NumPoints, NumTriangles, Seconds * 1000);
+
+		TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+		Result->SetStringField(TEXT("Benchmark"), TEXT("Triangulate"));
+		Result->SetNumberField(TEXT("OutlinePoints"), NumPoints);
+		Result->SetNumberField(TEXT("Triangles"), NumTriangles);
+		Result->SetNumberField(TEXT("BestMs"), Seconds * 1000);
+		OutResults.Add(MakeShared<FJsonValueObject>(Result));
+	}
+}
+
+void USplineSweepBenchmarkCommandlet::BenchmarkSweep(int Iterations, bool bQuick, TArray<TSharedPtr<FJsonValue>>& OutResults)
+{
+	using namespace SplineSweepBenchmark;
+	FCountingMalloc* CountingMalloc = GetCountingMalloc();
+
+	const TArray<float> PathLengths = bQuick ? TArray<float>{ 1000 } : TArray<float>{ 1000, 10000, 100000 };
+	const TArray<int> SegmentCounts = bQuick ? TArray<int>{ 16, 128 } : TArray<int>{ 16, 128, 1024 };
+	const TArray<int> ProfileSizes = bQuick ? TArray<int>{ 8, 32 } : TArray<int>{ 8, 32, 128 };
+
+	//Components are never registered,geometry and collision are built without a world
+	USplineComponent* SweepSpline = NewObject<USplineComponent>(GetTransientPackage());
+	USplineComponent* PathSpline = NewObject<USplineComponent>(GetTransientPackage());
+	SweepSpline->AddToRoot();
+	PathSpline->AddToRoot();
+	for (float PathLength : PathLengths)
+	{
+		MakePathSpline(PathLength, PathSpline);
+		for (int NumPoints : ProfileSizes)
+		{
+			MakeProfileSpline(NumPoints, 50, SweepSpline);
+			for (int NumSegments : SegmentCounts)
+			{
+				for (int Flags = 0; Flags < 4; Flags++)
+				{
+					const bool bSmoothNormal = (Flags & 1) != 0;
+					const bool bCollision = (Flags & 2) != 0;
+					USplineSweepMeshComponent* Component = NewObject<USplineSweepMeshComponent>(GetTransientPackage());
+					//Every iteration creates from the same inputs,none of them may be skipped
+					Component->bSkipUnchangedInputs = false;
+
+					FCallTiming Create;
+					FCallTiming Update;
+					for (int Iteration = 0; Iteration < Iterations; Iteration++)
+					{
+						CountingMalloc->Begin();
+						double Start = FPlatformTime::Seconds();
+						Component->CreateSweepMesh(SweepSpline, PathSpline, NumSegments, 1, bSmoothNormal, bCollision);
+						const double CreateSeconds = FPlatformTime::Seconds() - Start;
+						Create.Add(CreateSeconds, CountingMalloc->End());
+
+						//Rates stay below the rate of create,so every update generates geometry again
+						CountingMalloc->Begin();
+						Start = FPlatformTime::Seconds();
+						Component->UpdatePathSpline(PathSpline, 0.5f + 0.5f * Iteration / Iterations);
+						const double UpdateSeconds = FPlatformTime::Seconds() - Start;
+						Update.Add(UpdateSeconds, CountingMalloc->End());
+					}
+					const int NumTriangles = GetNumTriangles(Component);
+					if (Component->GetNumSkippedBuilds() > 0)
+					{
+						UE_LOG(LogSplineSweepBenchmark, Warning, TEXT("Sweep length=%.0f profile=%d segments=%d skipped %d builds,timings are not valid"),
+							PathLength, NumPoints, NumSegments, Component->GetNumSkippedBuilds());
+					}
+
+					UE_LOG(LogSplineSweepBenchmark, Display, TEXT("Sweep length=%.0f profile=%d segments=%d smooth=%d collision=%d triangles=%d create=%.3f ms (%.1f allocs) update=%.3f ms (%.1f allocs, %d buffer growths) %.2f Mtris/s"),
+						PathLength, NumPoints, NumSegments, bSmoothNormal, bCollision, NumTriangles,
+						Create.BestSeconds * 1000, Create.GetAllocationsPerCall(),
+						Update.BestSeconds * 1000, Update.GetAllocationsPerCall(), Component->GetLastUpdateAllocations(),
+						NumTriangles / FMath::Max(Update.BestSeconds, 1e-9) / 1e6);
+
+					TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+					Result->SetStringField(TEXT("Benchmark"), TEXT("Sweep"));
+					Result->SetNumberField(TEXT("PathLength"), PathLength);
+					Result->SetNumberField(TEXT("ProfilePoints"), NumPoints);
+					Result->SetNumberField(TEXT("NumSegments"), NumSegments);
+					Result->SetBoolField(TEXT("SmoothNormal"), bSmoothNormal);
+					Result->SetBoolField(TEXT("Collision"), bCollision);
+					Result->SetNumberField(TEXT("Triangles"), NumTriangles);
+					Create.Write(TEXT("Create"), NumTriangles, *Result);
+					Update.Write(TEXT("Update"), NumTriangles, *Result);
+					Result->SetNumberField(TEXT("UpdateBufferGrowths"), Component->GetLastUpdateAllocations());
+					OutResults.Add(MakeShared<FJsonValueObject>(Result));
+
+					Component->MarkPendingKill();
+				}
+			}
+		}
+		//Keep memory of finished cases from piling up
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+	SweepSpline->RemoveFromRoot();
+	PathSpline->RemoveFromRoot();
+}
+
+bool USplineSweepBenchmarkCommandlet::WriteResults(const FString& Path, int Iterations, const TArray<TSharedPtr<FJsonValue>>& Results) const
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("SplineSweepMesh"));
+	Root->SetStringField(TEXT("PluginVersion"), Plugin.IsValid() ? Plugin->GetDescriptor().VersionName : FString());
+	Root->SetStringField(TEXT("EngineVersion"), FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("Platform"), ANSI_TO_TCHAR(FPlatformProperties::IniPlatformName()));
+	Root->SetStringField(TEXT("Configuration"), LexToString(FApp::GetBuildConfiguration()));
+	Root->SetStringField(TEXT("Time"), FDateTime::UtcNow().ToIso8601());
+	Root->SetNumberField(TEXT("Iterations"), Iterations);
+	Root->SetArrayField(TEXT("Results"), Results);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	if (!FJsonSerializer::Serialize(Root, Writer) || !FFileHelper::SaveStringToFile(Json, *Path))
+	{
+		UE_LOG(LogSplineSweepBenchmark, Error, TEXT("Failed to write results to %s"), *Path);
+		return false;
+	}
+	UE_LOG(LogSplineSweepBenchmark, Display, TEXT("Results written to %s"), *FPaths::ConvertRelativePathToFull(Path));
+	return true;
+}
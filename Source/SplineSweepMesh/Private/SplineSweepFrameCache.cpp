@@ -0,0 +1,405 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepFrameCache.h"
+#include "HAL/ThreadSafeCounter.h"
+
+FMatrix FSplineSweepFrame::ToMatrix() const
+{
+	FVector X = Rotation.GetAxisX();
+	FVector Y = Rotation.GetAxisY() * Scale.Y;
+	FVector Z = Rotation.GetAxisZ() * Scale.Z;
+
+	return FMatrix(FPlane(X, 0), FPlane(Y, 0), FPlane(Z, 0), FPlane(Location, 1));
+}
+
+void FSplineSweepPathSnapshot::Capture(const USplineComponent* InPath)
+{
+	SPLINESWEEP_SCOPE(ReadSplines);
+	Path = InPath;
+	Curves = InPath->SplineCurves;
+	DefaultUpVector = InPath->GetDefaultUpVector(ESplineCoordinateSpace::Local);
+}
+
+namespace SplineSweepFrameCache
+{
+	template<typename T>
+	bool ArePointsEqual(const FInterpCurvePoint<T>& A, const FInterpCurvePoint<T>& B)
+	{
+		return A.InVal == B.InVal && A.OutVal == B.OutVal && A.ArriveTangent == B.ArriveTangent
+			&& A.LeaveTangent == B.LeaveTangent && A.InterpMode == B.InterpMode;
+	}
+}
+
+bool FSplineSweepPathSnapshot::FindChangedSegments(const FSplineSweepPathSnapshot& Older, TArray<bool>& OutDirtySegments) const
+{
+	using namespace SplineSweepFrameCache;
+
+	const int NumPoints = Curves.Position.Points.Num();
+	const int NumSegments = Curves.Position.bIsLooped ? NumPoints : FMath::Max(NumPoints - 1, 0);
+	OutDirtySegments.Init(true, NumSegments);
+	if (Older.Path != Path || Older.DefaultUpVector != DefaultUpVector
+		|| Older.Curves.Position.Points.Num() != NumPoints || Older.Curves.Rotation.Points.Num() != Curves.Rotation.Points.Num()
+		|| Older.Curves.Scale.Points.Num() != Curves.Scale.Points.Num() || Older.Curves.Position.bIsLooped != Curves.Position.bIsLooped
+		|| Older.Curves.Position.LoopKeyOffset != Curves.Position.LoopKeyOffset)
+	{
+		return false;
+	}
+
+	OutDirtySegments.Init(false, NumSegments);
+	for (int i = 0; i < NumPoints; i++)
+	{
+		const bool bChanged = !ArePointsEqual(Curves.Position.Points[i], Older.Curves.Position.Points[i])
+			|| (Curves.Rotation.Points.IsValidIndex(i) && !ArePointsEqual(Curves.Rotation.Points[i], Older.Curves.Rotation.Points[i]))
+			|| (Curves.Scale.Points.IsValidIndex(i) && !ArePointsEqual(Curves.Scale.Points[i], Older.Curves.Scale.Points[i]));
+		//Point i is shared by segment before and after it.Auto tangents of neighbours are stored in their own points
+		if (bChanged && NumSegments > 0)
+		{
+			if (i < NumSegments)
+			{
+				OutDirtySegments[i] = true;
+			}
+			if (i > 0)
+			{
+				OutDirtySegments[i - 1] = true;
+			}
+			else if (Curves.Position.bIsLooped)
+			{
+				OutDirtySegments[NumSegments - 1] = true;
+			}
+		}
+	}
+	return true;
+}
+
+int FSplineSweepPathSnapshot::GetSegmentAtInputKey(float InputKey) const
+{
+	const int NumPoints = Curves.Position.Points.Num();
+	const int NumSegments = Curves.Position.bIsLooped ? NumPoints : NumPoints - 1;
+	return FMath::Clamp(Curves.Position.GetPointIndexForInputValue(InputKey), 0, FMath::Max(NumSegments - 1, 0));
+}
+
+namespace SplineSweepFrameCache
+{
+	//Move cursor forward to the last point at or before key,same point as FInterpCurve::GetPointIndexForInputValue finds
+	template<typename T>
+	int AdvanceCursor(const FInterpCurve<T>& Curve, int Cursor, float Key)
+	{
+		const int LastPoint = Curve.Points.Num() - 1;
+		if (LastPoint < 0 || Key < Curve.Points[0].InVal)
+		{
+			return INDEX_NONE;
+		}
+		Cursor = FMath::Max(Cursor, 0);
+		while (Cursor < LastPoint && Curve.Points[Cursor + 1].InVal <= Key)
+		{
+			Cursor++;
+		}
+		return Cursor;
+	}
+
+	//Segment of curve a key lies in,false if key is outside of every segment and value of a single point applies
+	template<typename T>
+	bool GetSegment(const FInterpCurve<T>& Curve, int Index, float Key, int& OutNext, float& OutDiff)
+	{
+		const int NumPoints = Curve.Points.Num();
+		if (Index == INDEX_NONE || (Index == NumPoints - 1 && (!Curve.bIsLooped || Key >= Curve.Points[Index].InVal + Curve.LoopKeyOffset)))
+		{
+			return false;
+		}
+		const bool bLoopSegment = Curve.bIsLooped && Index == NumPoints - 1;
+		OutNext = bLoopSegment ? 0 : Index + 1;
+		OutDiff = bLoopSegment ? Curve.LoopKeyOffset : Curve.Points[OutNext].InVal - Curve.Points[Index].InVal;
+		return true;
+	}
+
+	//FInterpCurve::Eval with the point already found
+	template<typename T>
+	T EvalAtPoint(const FInterpCurve<T>& Curve, int Index, float Key, const T& Default)
+	{
+		const int NumPoints = Curve.Points.Num();
+		if (NumPoints == 0)
+		{
+			return Default;
+		}
+		int Next;
+		float Diff;
+		if (!GetSegment(Curve, Index, Key, Next, Diff))
+		{
+			//Looped curve ends on its first point
+			return Index == INDEX_NONE || Curve.bIsLooped ? Curve.Points[0].OutVal : Curve.Points[Index].OutVal;
+		}
+		const FInterpCurvePoint<T>& Prev = Curve.Points[Index];
+		const FInterpCurvePoint<T>& NextPoint = Curve.Points[Next];
+		if (Diff <= 0 || Prev.InterpMode == CIM_Constant)
+		{
+			return Prev.OutVal;
+		}
+		const float Alpha = (Key - Prev.InVal) / Diff;
+		if (Prev.InterpMode == CIM_Linear)
+		{
+			return FMath::Lerp(Prev.OutVal, NextPoint.OutVal, Alpha);
+		}
+		return FMath::CubicInterp(Prev.OutVal, Prev.LeaveTangent * Diff, NextPoint.OutVal, NextPoint.ArriveTangent * Diff, Alpha);
+	}
+
+	//FInterpCurve::EvalDerivative with the point already found
+	FVector EvalDerivativeAtPoint(const FInterpCurveVector& Curve, int Index, float Key)
+	{
+		const int NumPoints = Curve.Points.Num();
+		if (NumPoints == 0)
+		{
+			return FVector::ZeroVector;
+		}
+		int Next;
+		float Diff;
+		if (!GetSegment(Curve, Index, Key, Next, Diff))
+		{
+			return Index == INDEX_NONE ? Curve.Points[0].LeaveTangent : Curve.bIsLooped ? Curve.Points[0].ArriveTangent : Curve.Points[Index].ArriveTangent;
+		}
+		const FInterpCurvePoint<FVector>& Prev = Curve.Points[Index];
+		const FInterpCurvePoint<FVector>& NextPoint = Curve.Points[Next];
+		if (Diff <= 0 || Prev.InterpMode == CIM_Constant)
+		{
+			return FVector::ZeroVector;
+		}
+		if (Prev.InterpMode == CIM_Linear)
+		{
+			return (NextPoint.OutVal - Prev.OutVal) / Diff;
+		}
+		const float Alpha = (Key - Prev.InVal) / Diff;
+		return FMath::CubicInterpDerivative(Prev.OutVal, Prev.LeaveTangent * Diff, NextPoint.OutVal, NextPoint.ArriveTangent * Diff, Alpha) / Diff;
+	}
+}
+
+FSplineSweepPathSampler::FSplineSweepPathSampler(const FSplineSweepPathSnapshot& InSnapshot, bool bInRotationMinimizing)
+	: Curves(InSnapshot.Curves)
+	, DefaultUpVector(InSnapshot.DefaultUpVector)
+	, bRotationMinimizing(bInRotationMinimizing)
+{
+}
+
+FSplineSweepFrame FSplineSweepPathSampler::Next(float Distance)
+{
+	using namespace SplineSweepFrameCache;
+
+	ReparamCursor = AdvanceCursor(Curves.ReparamTable, ReparamCursor, Distance);
+	const float Key = EvalAtPoint(Curves.ReparamTable, ReparamCursor, Distance, 0.0f);
+	PositionCursor = AdvanceCursor(Curves.Position, PositionCursor, Key);
+	RotationCursor = AdvanceCursor(Curves.Rotation, RotationCursor, Key);
+	ScaleCursor = AdvanceCursor(Curves.Scale, ScaleCursor, Key);
+
+	FSplineSweepFrame Frame;
+	Frame.InputKey = Key;
+	Frame.Location = EvalAtPoint(Curves.Position, PositionCursor, Key, FVector::ZeroVector);
+	Frame.Scale = EvalAtPoint(Curves.Scale, ScaleCursor, Key, FVector(1.0f));
+	const FVector Direction = EvalDerivativeAtPoint(Curves.Position, PositionCursor, Key).GetSafeNormal();
+
+	FVector UpVector;
+	if (bRotationMinimizing && bHasPrevious)
+	{
+		//Double reflection,reflect previous frame onto this location,then align its direction with this one
+		const FVector V1 = Frame.Location - PreviousLocation;
+		const float C1 = V1.SizeSquared();
+		FVector ReflectedUp = PreviousUp;
+		FVector ReflectedDirection = PreviousDirection;
+		if (C1 > SMALL_NUMBER)
+		{
+			ReflectedUp -= (2 / C1) * FVector::DotProduct(V1, PreviousUp) * V1;
+			ReflectedDirection -= (2 / C1) * FVector::DotProduct(V1, PreviousDirection) * V1;
+		}
+		const FVector V2 = Direction - ReflectedDirection;
+		const float C2 = V2.SizeSquared();
+		UpVector = C2 > SMALL_NUMBER ? ReflectedUp - (2 / C2) * FVector::DotProduct(V2, ReflectedUp) * V2 : ReflectedUp;
+	}
+	else
+	{
+		FQuat Quat = EvalAtPoint(Curves.Rotation, RotationCursor, Key, FQuat::Identity);
+		Quat.Normalize();
+		UpVector = Quat.RotateVector(DefaultUpVector);
+	}
+
+	//Rotation is made from direction and up vector of path
+	Frame.Rotation = FRotationMatrix::MakeFromXZ(Direction, UpVector).ToQuat();
+	Frame.Direction = Frame.Rotation.GetAxisX();
+
+	bHasPrevious = true;
+	PreviousLocation = Frame.Location;
+	PreviousDirection = Frame.Direction;
+	PreviousUp = Frame.Rotation.GetAxisZ();
+	return Frame;
+}
+
+bool FSplineSweepFrameCache::IsUpToDate(const USplineComponent* Path, int SamplesPerSegment, bool bRotationMinimizing) const
+{
+	//Sweep is built in local space of path,so transform of path does not change the table
+	return IsValid() && CachedPath == Path && CachedVersion == Path->SplineCurves.Version
+		&& CachedUpVector == Path->GetDefaultUpVector(ESplineCoordinateSpace::Local)
+		&& CachedSamplesPerSegment == FMath::Max(SamplesPerSegment, 1) && bCachedRotationMinimizing == bRotationMinimizing;
+}
+
+void FSplineSweepFrameCache::Build(const FSplineSweepPathSnapshot& Snapshot, int SamplesPerSegment, bool bRotationMinimizing)
+{
+	SPLINESWEEP_SCOPE(EvaluateFrames);
+	static FThreadSafeCounter NextSerial;
+	Serial = NextSerial.Increment();
+
+	const FSplineCurves& Curves = Snapshot.Curves;
+	SamplesPerSegment = FMath::Max(SamplesPerSegment, 1);
+	CachedPath = Snapshot.Path;
+	CachedVersion = Curves.Version;
+	CachedUpVector = Snapshot.DefaultUpVector;
+	CachedSamplesPerSegment = SamplesPerSegment;
+	bCachedRotationMinimizing = bRotationMinimizing;
+
+	const int NumPoints = Curves.Position.Points.Num();
+	const int NumSplineSegments = FMath::Max(Curves.Position.bIsLooped ? NumPoints : NumPoints - 1, 1);
+	const int NumSamples = NumSplineSegments * SamplesPerSegment + 1;
+
+	SplineLength = Curves.ReparamTable.Points.Num() > 0 ? Curves.ReparamTable.Points.Last().InVal : 0.0f;
+	SampleSpacing = SplineLength / (NumSamples - 1);
+
+	//Samples are taken in order of distance,so the sampler walks the path once
+	FSplineSweepPathSampler Sampler(Snapshot, bRotationMinimizing);
+	Frames.SetNumUninitialized(NumSamples, false);
+	for (int i = 0; i < NumSamples; i++)
+	{
+		Frames[i] = Sampler.Next(i * SampleSpacing);
+	}
+
+	LastPointFrame = EvaluateFrameAtInputKey(Curves, Snapshot.DefaultUpVector, NumPoints > 0 ? Curves.Position.Points.Last().InVal : 0.0f);
+	LastPointFrame.Location = Frames.Last().Location;
+	if (bRotationMinimizing)
+	{
+		//Keep the carried up vector past the end of path
+		LastPointFrame.Rotation = Frames.Last().Rotation;
+		LastPointFrame.Direction = Frames.Last().Direction;
+	}
+	MemoryCounter.Set(Frames.GetAllocatedSize());
+}
+
+FSplineSweepFrame FSplineSweepFrameCache::GetFrameAtDistance(float Distance) const
+{
+	if (!IsValid())
+	{
+		return FSplineSweepFrame();
+	}
+	//If distance is too long,use frame in the end of path
+	if (Distance > SplineLength)
+	{
+		return LastPointFrame;
+	}
+	if (SampleSpacing <= 0 || Distance <= 0)
+	{
+		return Frames[0];
+	}
+
+	const float Position = Distance / SampleSpacing;
+	const int Index = FMath::Min(FMath::FloorToInt(Position), Frames.Num() - 2);
+	const float Alpha = FMath::Clamp(Position - Index, 0.0f, 1.0f);
+	const FSplineSweepFrame& F0 = Frames[Index];
+	const FSplineSweepFrame& F1 = Frames[Index + 1];
+
+	FSplineSweepFrame Frame;
+	//Path is parameterized by distance,so unit direction is the derivative used by hermite interpolation
+	Frame.Location = FMath::CubicInterp(F0.Location, F0.Direction * SampleSpacing, F1.Location, F1.Direction * SampleSpacing, Alpha);
+	Frame.Rotation = FQuat::Slerp(F0.Rotation, F1.Rotation, Alpha);
+	Frame.Direction = Frame.Rotation.GetAxisX();
+	Frame.Scale = FMath::Lerp(F0.Scale, F1.Scale, Alpha);
+	Frame.InputKey = FMath::Lerp(F0.InputKey, F1.InputKey, Alpha);
+	return Frame;
+}
+
+void FSplineSweepFrameCache::FindAdaptiveRingDistances(float MaxDeviation, float MaxAngle, float ProfileRadius, int MinSegments, int MaxSegments, TArray<float>& OutDistances) const
+{
+	MinSegments = FMath::Max(MinSegments, 1);
+	MaxSegments = FMath::Max(MaxSegments, MinSegments);
+	const int LastSample = Frames.Num() - 1;
+	//Too few cached frames to honour the minimum,spread rings evenly
+	if (LastSample < MinSegments)
+	{
+		OutDistances.SetNumUninitialized(MinSegments + 1, false);
+		for (int i = 0; i <= MinSegments; i++)
+		{
+			OutDistances[i] = SplineLength * i / MinSegments;
+		}
+		return;
+	}
+
+	const int MaxSpan = LastSample / MinSegments;
+	float AngleRadians = FMath::DegreesToRadians(FMath::Max(MaxAngle, KINDA_SMALL_NUMBER));
+	MaxDeviation = FMath::Max(MaxDeviation, KINDA_SMALL_NUMBER);
+	//Each pass doubles both tolerances,a handful of passes is enough to fit any reasonable cap
+	const int MaxPasses = 8;
+	for (int Pass = 0; Pass < MaxPasses; Pass++)
+	{
+		OutDistances.Reset();
+		OutDistances.Add(0);
+		int Start = 0;
+		while (Start < LastSample && OutDistances.Num() <= MaxSegments + 1)
+		{
+			//Extend span one frame at a time,until the next frame would break tolerance
+			int End = Start + 1;
+			while (End < LastSample && End - Start < MaxSpan && IsSpanWithinTolerance(Start, End + 1, MaxDeviation, AngleRadians, ProfileRadius))
+			{
+				End++;
+			}
+			OutDistances.Add(End == LastSample ? SplineLength : End * SampleSpacing);
+			Start = End;
+		}
+		if (Start == LastSample && OutDistances.Num() <= MaxSegments + 1)
+		{
+			return;
+		}
+		MaxDeviation *= 2;
+		AngleRadians *= 2;
+	}
+
+	OutDistances.SetNumUninitialized(MaxSegments + 1, false);
+	for (int i = 0; i <= MaxSegments; i++)
+	{
+		OutDistances[i] = SplineLength * i / MaxSegments;
+	}
+}
+
+bool FSplineSweepFrameCache::IsSpanWithinTolerance(int Start, int End, float MaxDeviation, float MaxAngle, float ProfileRadius) const
+{
+	const FSplineSweepFrame& A = Frames[Start];
+	const FSplineSweepFrame& B = Frames[End];
+	if (A.Rotation.AngularDistance(B.Rotation) > MaxAngle)
+	{
+		return false;
+	}
+	for (int i = Start + 1; i < End; i++)
+	{
+		//Surface between two rings is linear,compare it with the frame it passes
+		const FSplineSweepFrame& F = Frames[i];
+		const float Alpha = float(i - Start) / (End - Start);
+		const float LocationError = (F.Location - FMath::Lerp(A.Location, B.Location, Alpha)).Size();
+		//Profile points at radius move on a chord when frame turns away from interpolated rotation
+		const float Turn = F.Rotation.AngularDistance(FQuat::Slerp(A.Rotation, B.Rotation, Alpha));
+		const float RotationError = 2 * FMath::Sin(Turn * 0.5f) * ProfileRadius * F.Scale.GetAbsMax();
+		const float ScaleError = (F.Scale - FMath::Lerp(A.Scale, B.Scale, Alpha)).GetAbsMax() * ProfileRadius;
+		if (LocationError + RotationError + ScaleError > MaxDeviation)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+FSplineSweepFrame FSplineSweepFrameCache::EvaluateFrameAtInputKey(const FSplineCurves& Curves, const FVector& DefaultUpVector, float InputKey)
+{
+	FSplineSweepFrame Frame;
+	Frame.InputKey = InputKey;
+	Frame.Location = Curves.Position.Eval(InputKey, FVector::ZeroVector);
+	Frame.Scale = Curves.Scale.Eval(InputKey, FVector(1.0f));
+
+	//Rotation is made from direction and up vector of path
+	FQuat Quat = Curves.Rotation.Eval(InputKey, FQuat::Identity);
+	Quat.Normalize();
+	const FVector Direction = Curves.Position.EvalDerivative(InputKey, FVector::ZeroVector).GetSafeNormal();
+	const FVector UpVector = Quat.RotateVector(DefaultUpVector);
+	Frame.Rotation = FRotationMatrix::MakeFromXZ(Direction, UpVector).ToQuat();
+	Frame.Direction = Frame.Rotation.GetAxisX();
+	return Frame;
+}
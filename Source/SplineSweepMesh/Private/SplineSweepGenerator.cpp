@@ -0,0 +1,587 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepGenerator.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Async/ParallelFor.h"
+
+void FSplineSweepMeshBuffers::SwapVertexData(FSplineSweepMeshBuffers& Other)
+{
+	Swap(SweptPoints, Other.SweptPoints);
+	Swap(SweptNormals, Other.SweptNormals);
+	Swap(SweptUVs, Other.SweptUVs);
+	Swap(SideVertices, Other.SideVertices);
+	Swap(SideNormals, Other.SideNormals);
+	Swap(SideUVs, Other.SideUVs);
+	Swap(SideTangents, Other.SideTangents);
+	Swap(CoverVertices, Other.CoverVertices);
+	Swap(CoverNormals, Other.CoverNormals);
+	Swap(CoverTangents, Other.CoverTangents);
+	Swap(Allocations, Other.Allocations);
+	Swap(RingKeys, Other.RingKeys);
+	Swap(RingFractions, Other.RingFractions);
+	Swap(RingFractionsFrameSerial, Other.RingFractionsFrameSerial);
+	Swap(NumValidFixedRings, Other.NumValidFixedRings);
+	Swap(FixedRingsFrameSerial, Other.FixedRingsFrameSerial);
+	UpdateMemoryStat();
+	Other.UpdateMemoryStat();
+}
+
+void FSplineSweepMeshBuffers::SwapAll(FSplineSweepMeshBuffers& Other)
+{
+	SwapVertexData(Other);
+	Swap(SideIndices, Other.SideIndices);
+	Swap(CoverIndices, Other.CoverIndices);
+	UpdateMemoryStat();
+	Other.UpdateMemoryStat();
+}
+
+SIZE_T FSplineSweepMeshBuffers::GetAllocatedSize() const
+{
+	return SweptPoints.GetAllocatedSize() + SweptNormals.GetAllocatedSize() + SweptUVs.GetAllocatedSize()
+		+ SideVertices.GetAllocatedSize() + SideIndices.GetAllocatedSize() + SideNormals.GetAllocatedSize() + SideUVs.GetAllocatedSize() + SideTangents.GetAllocatedSize()
+		+ CoverVertices.GetAllocatedSize() + CoverIndices.GetAllocatedSize() + CoverNormals.GetAllocatedSize() + CoverTangents.GetAllocatedSize()
+		+ RingKeys.GetAllocatedSize() + RingFractions.GetAllocatedSize();
+}
+
+//Tangent along TangentX made orthogonal to normal,binormal is flipped if it would point against Bitangent
+static FProcMeshTangent MakeTangent(const FVector& TangentX, const FVector& Normal, const FVector& Bitangent, bool bFlipTangentY)
+{
+	const FVector X = (TangentX - Normal * FVector::DotProduct(TangentX, Normal)).GetSafeNormal();
+	const bool bMirrored = FVector::DotProduct(FVector::CrossProduct(Normal, X), Bitangent) < 0;
+	return FProcMeshTangent(X, bMirrored != bFlipTangentY);
+}
+
+FSplineSweepGenerator::FSplineSweepGenerator(const FSplineSweepProfile& InProfile, const FSplineSweepFrameCache& InFrames, const FSplineSweepSettings& InSettings)
+	: Profile(InProfile)
+	, Frames(InFrames)
+	, Settings(InSettings)
+{
+}
+
+void FSplineSweepGenerator::Build(float Rate, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const
+{
+	BuildSide(Rate, Buffers, bBuildIndices);
+	if (Settings.bHaveCover)
+	{
+		BuildCovers(Rate, Buffers, bBuildIndices);
+	}
+	Buffers.UpdateMemoryStat();
+}
+
+void FSplineSweepGenerator::BuildSide(float Rate, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const
+{
+	//Use profile to sweep along path to create side points.Rings are shared by neighbour segments if use smoothed normal,so sweep straight into section buffers
+	TArray<FVector>& OutPoints = Settings.bSmoothNormal ? Buffers.SideVertices : Buffers.SweptPoints;
+	TArray<FVector>& OutNormals = Settings.bSmoothNormal ? Buffers.SideNormals : Buffers.SweptNormals;
+	TArray<FVector2D>& OutUVs = Settings.bSmoothNormal ? Buffers.SideUVs : Buffers.SweptUVs;
+	//New topology,nothing retained from an older mesh is valid
+	if (bBuildIndices)
+	{
+		Buffers.SideIndices.Reset();
+		Buffers.NumValidFixedRings = 0;
+		Buffers.RingFractionsFrameSerial = 0;
+	}
+
+	if (Settings.bFixedSpacingGrowth)
+	{
+		//Number of rings follows rate,indices are grown and trimmed with them
+		int NumRings = 0;
+		const int FirstRing = SweepPointsAtFixedSpacing(Rate, Buffers, OutPoints, OutNormals, OutUVs, NumRings);
+		const int SegmentsNumber = FMath::Max(NumRings - 1, 0);
+		if (!Settings.bSmoothNormal)
+		{
+			//Segment before first written ring ends on it
+			ExpandSweptPointsIntoQuads(Buffers, SegmentsNumber, FMath::Max(FirstRing - 1, 0));
+		}
+		ResizeSideTangents(Buffers);
+		ResizeSideIndices(Buffers, SegmentsNumber);
+		return;
+	}
+
+	if (Settings.bAdaptiveSegments)
+	{
+		PlaceAdaptiveRings(Buffers);
+	}
+	const int SegmentsNumber = GetNumSegments(Buffers);
+	SweepPointsAlongSpline(Rate, Buffers, OutPoints, OutNormals, OutUVs);
+	if (!Settings.bSmoothNormal)
+	{
+		ExpandSweptPointsIntoQuads(Buffers, SegmentsNumber);
+	}
+	ResizeSideTangents(Buffers);
+	//Adaptive rings are placed again when path changes,so their number may change on any update
+	if (bBuildIndices || Settings.bAdaptiveSegments)
+	{
+		ResizeSideIndices(Buffers, SegmentsNumber);
+	}
+}
+
+int FSplineSweepGenerator::PrepareSide(float Rate, FSplineSweepMeshBuffers& Buffers) const
+{
+	//Rings at fixed spacing are swept in order of the rings already valid,there is nothing to split
+	if (Settings.bFixedSpacingGrowth)
+	{
+		BuildSide(Rate, Buffers, true);
+		return FMath::Max(Buffers.RingKeys.Num() - 1, 0);
+	}
+
+	Buffers.SideIndices.Reset();
+	Buffers.NumValidFixedRings = 0;
+	Buffers.RingFractionsFrameSerial = 0;
+	if (Settings.bAdaptiveSegments)
+	{
+		PlaceAdaptiveRings(Buffers);
+	}
+	const int SegmentsNumber = GetNumSegments(Buffers);
+	const int RingSize = Profile.Num();
+	TArray<FVector>& OutPoints = Settings.bSmoothNormal ? Buffers.SideVertices : Buffers.SweptPoints;
+	TArray<FVector>& OutNormals = Settings.bSmoothNormal ? Buffers.SideNormals : Buffers.SweptNormals;
+	TArray<FVector2D>& OutUVs = Settings.bSmoothNormal ? Buffers.SideUVs : Buffers.SweptUVs;
+	Buffers.Resize(OutPoints, (SegmentsNumber + 1) * RingSize);
+	Buffers.Resize(OutNormals, (SegmentsNumber + 1) * RingSize);
+	Buffers.Resize(OutUVs, (SegmentsNumber + 1) * RingSize);
+	Buffers.Resize(Buffers.RingKeys, SegmentsNumber + 1);
+	if (!Settings.bSmoothNormal)
+	{
+		Buffers.Resize(Buffers.SideVertices, SegmentsNumber * RingSize * 4);
+		Buffers.Resize(Buffers.SideNormals, SegmentsNumber * RingSize * 4);
+		Buffers.Resize(Buffers.SideUVs, SegmentsNumber * RingSize * 4);
+	}
+	ResizeSideTangents(Buffers);
+	ResizeSideIndices(Buffers, SegmentsNumber);
+	return SegmentsNumber;
+}
+
+void FSplineSweepGenerator::BuildSideSegments(float Rate, FSplineSweepMeshBuffers& Buffers, int FirstSegment, int LastSegment) const
+{
+	if (Settings.bFixedSpacingGrowth)
+	{
+		return;
+	}
+	const int SegmentsNumber = GetNumSegments(Buffers);
+	TArray<FVector>& OutPoints = Settings.bSmoothNormal ? Buffers.SideVertices : Buffers.SweptPoints;
+	TArray<FVector>& OutNormals = Settings.bSmoothNormal ? Buffers.SideNormals : Buffers.SweptNormals;
+	TArray<FVector2D>& OutUVs = Settings.bSmoothNormal ? Buffers.SideUVs : Buffers.SweptUVs;
+	//A segment needs the ring at its end too
+	SweepPointsAlongSpline(Rate, Buffers, OutPoints, OutNormals, OutUVs, FirstSegment, LastSegment + 1);
+	if (!Settings.bSmoothNormal)
+	{
+		ExpandSweptPointsIntoQuads(Buffers, SegmentsNumber, FirstSegment, LastSegment);
+	}
+}
+
+int FSplineSweepGenerator::GetNumSegments(const FSplineSweepMeshBuffers& Buffers) const
+{
+	if (Settings.bAdaptiveSegments && !Settings.bFixedSpacingGrowth)
+	{
+		return FMath::Max(Buffers.RingFractions.Num() - 1, 1);
+	}
+	return Settings.NumSegments;
+}
+
+void FSplineSweepGenerator::PlaceAdaptiveRings(FSplineSweepMeshBuffers& Buffers) const
+{
+	SPLINESWEEP_SCOPE(EvaluateFrames);
+	//Rings are placed on the whole path,so rate only moves them and topology stays fixed while growing
+	if (Buffers.RingFractionsFrameSerial == Frames.GetSerial() && Buffers.RingFractions.Num() > 1)
+	{
+		return;
+	}
+	Buffers.RingFractionsFrameSerial = Frames.GetSerial();
+
+	const float SplineLength = Frames.GetSplineLength();
+	Frames.FindAdaptiveRingDistances(Settings.MaxChordDeviation, Settings.MaxSegmentAngle, Profile.GetRadius(), Settings.MinSegments, Settings.MaxSegments, Buffers.RingFractions);
+	for (float& Fraction : Buffers.RingFractions)
+	{
+		Fraction = SplineLength > 0 ? Fraction / SplineLength : 0;
+	}
+}
+
+void FSplineSweepGenerator::ResizeSideTangents(FSplineSweepMeshBuffers& Buffers) const
+{
+	//Tangents are written with the vertices they belong to,this only keeps the count in step.An empty array makes mesh sections use default tangents
+	if (Settings.bGenerateTangents)
+	{
+		Buffers.Resize(Buffers.SideTangents, Buffers.SideVertices.Num());
+	}
+	else
+	{
+		Buffers.SideTangents.Reset();
+	}
+}
+
+void FSplineSweepGenerator::ResizeSideIndices(FSplineSweepMeshBuffers& Buffers, int SegmentsNumber) const
+{
+	const int RingSize = Profile.Num();
+	TArray<int>& SideIndices = Buffers.SideIndices;
+	const int IndicesPerSegment = RingSize * 6;
+	const int ExistingSegments = IndicesPerSegment > 0 ? SideIndices.Num() / IndicesPerSegment : 0;
+	if (ExistingSegments >= SegmentsNumber)
+	{
+		SideIndices.SetNum(SegmentsNumber * IndicesPerSegment, false);
+		return;
+	}
+
+	SideIndices.Reserve(SegmentsNumber * IndicesPerSegment);
+	for (int i = ExistingSegments; i < SegmentsNumber; i++)
+	{
+		for (int j = 0; j < RingSize; j++)
+		{
+			if (Settings.bSmoothNormal)
+			{
+				//Create triangles
+				int p1 = i * RingSize;
+				int p2 = (i + 1) * RingSize;
+				int n = (j + 1) == RingSize ? 0 : (j + 1);
+
+				SideIndices.Add(p1 + j);
+				SideIndices.Add(p1 + n);
+				SideIndices.Add(p2 + j);
+				SideIndices.Add(p1 + n);
+				SideIndices.Add(p2 + n);
+				SideIndices.Add(p2 + j);
+			}
+			else
+			{
+				//Each quad owns four vertices
+				int q = (i * RingSize + j) * 4;
+
+				SideIndices.Add(q);
+				SideIndices.Add(q + 2);
+				SideIndices.Add(q + 1);
+				SideIndices.Add(q + 2);
+				SideIndices.Add(q + 3);
+				SideIndices.Add(q + 1);
+			}
+		}
+	}
+}
+
+float FSplineSweepGenerator::GetGrownLength(float Rate) const
+{
+	//Fixed spacing can not grow past the end of path
+	if (Settings.bFixedSpacingGrowth)
+	{
+		Rate = FMath::Clamp(Rate, 0.0f, 1.0f);
+	}
+	return Frames.GetSplineLength() * Rate;
+}
+
+void FSplineSweepGenerator::BuildCovers(float Rate, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const
+{
+	//Transform matrix at start and end of path
+	BuildCoversAt(Frames.GetMatrixAtDistance(0), Frames.GetMatrixAtDistance(GetGrownLength(Rate)), Buffers, bBuildIndices);
+}
+
+void FSplineSweepGenerator::BuildCoversAt(const FMatrix& M0, const FMatrix& M1, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const
+{
+	SPLINESWEEP_SCOPE(BuildCovers);
+	//Each cover is the profile ring at an end of path,fanned by the triangulation of profile
+	const int RingSize = Profile.Num();
+	Buffers.Resize(Buffers.CoverVertices, RingSize * 2);
+	Buffers.Resize(Buffers.CoverNormals, RingSize * 2);
+	if (RingSize == 0)
+	{
+		return;
+	}
+
+	//Transform the two rings,normals written by the ring transform are replaced by the cover normal below
+	if (Settings.bVectorized)
+	{
+		Profile.TransformRing(M0, &Buffers.CoverVertices[0], &Buffers.CoverNormals[0]);
+		Profile.TransformRing(M1, &Buffers.CoverVertices[RingSize], &Buffers.CoverNormals[RingSize]);
+	}
+	else
+	{
+		Profile.TransformRingScalar(M0, &Buffers.CoverVertices[0], &Buffers.CoverNormals[0]);
+		Profile.TransformRingScalar(M1, &Buffers.CoverVertices[RingSize], &Buffers.CoverNormals[RingSize]);
+	}
+
+	//Covers are planar and lie across path,their normals are path direction of the frames.Start cover faces backward
+	const FVector n0 = M0.GetScaledAxis(EAxis::X).GetSafeNormal() * Profile.GetCoverWinding();
+	const FVector n1 = M1.GetScaledAxis(EAxis::X).GetSafeNormal() * -Profile.GetCoverWinding();
+	for (int j = 0; j < RingSize; j++)
+	{
+		Buffers.CoverNormals[j] = n0;
+		Buffers.CoverNormals[RingSize + j] = n1;
+	}
+
+	if (Settings.bGenerateTangents)
+	{
+		//Cover planes are spanned by Y and Z of the frames,tangent follows Y.Covers have no UVs,only keep the basis consistent
+		Buffers.Resize(Buffers.CoverTangents, RingSize * 2);
+		const FProcMeshTangent t0(UKismetMathLibrary::ProjectVectorOnToPlane(M0.GetScaledAxis(EAxis::Y), n0).GetSafeNormal(), Settings.bFlipTangentY);
+		const FProcMeshTangent t1(UKismetMathLibrary::ProjectVectorOnToPlane(M1.GetScaledAxis(EAxis::Y), n1).GetSafeNormal(), Settings.bFlipTangentY);
+		for (int j = 0; j < RingSize; j++)
+		{
+			Buffers.CoverTangents[j] = t0;
+			Buffers.CoverTangents[RingSize + j] = t1;
+		}
+	}
+	else
+	{
+		Buffers.CoverTangents.Reset();
+	}
+
+	if (bBuildIndices)
+	{
+		//Triangulation of profile is kept as indices,start cover is wound the other way to face backward
+		const TArray<int>& CoverTriangles = Profile.GetCoverTriangles();
+		const int NumTriangles = CoverTriangles.Num() / 3;
+		Buffers.CoverIndices.SetNumUninitialized(NumTriangles * 6);
+		for (int i = 0; i < NumTriangles; i++)
+		{
+			const int A = CoverTriangles[i * 3];
+			const int B = CoverTriangles[i * 3 + 1];
+			const int C = CoverTriangles[i * 3 + 2];
+			int* indices = &Buffers.CoverIndices[i * 6];
+			indices[0] = A;
+			indices[1] = C;
+			indices[2] = B;
+			indices[3] = RingSize + A;
+			indices[4] = RingSize + B;
+			indices[5] = RingSize + C;
+		}
+	}
+}
+
+void FSplineSweepGenerator::ExpandSweptPointsIntoQuads(FSplineSweepMeshBuffers& Buffers, int SegmentsNumber, int FirstSegment, int LastSegment) const
+{
+	SPLINESWEEP_SCOPE(ExpandQuads);
+	const int RingSize = Profile.Num();
+	Buffers.Resize(Buffers.SideVertices, SegmentsNumber * RingSize * 4);
+	Buffers.Resize(Buffers.SideNormals, SegmentsNumber * RingSize * 4);
+	Buffers.Resize(Buffers.SideUVs, SegmentsNumber * RingSize * 4);
+	if (Settings.bGenerateTangents)
+	{
+		Buffers.Resize(Buffers.SideTangents, SegmentsNumber * RingSize * 4);
+	}
+
+	const TArray<FVector>& SweptPoints = Buffers.SweptPoints;
+	const TArray<FVector2D>& SweptUVs = Buffers.SweptUVs;
+	TArray<FVector>& SideVertices = Buffers.SideVertices;
+	TArray<FVector>& SideNormals = Buffers.SideNormals;
+	TArray<FVector2D>& SideUVs = Buffers.SideUVs;
+	TArray<FProcMeshTangent>& SideTangents = Buffers.SideTangents;
+
+	//Convert side points into quad,written straight into section buffers.Each segment owns its own slice
+	LastSegment = LastSegment == INDEX_NONE ? SegmentsNumber - 1 : FMath::Min(LastSegment, SegmentsNumber - 1);
+	const int NumExpanded = FMath::Max(LastSegment - FirstSegment + 1, 0);
+	ParallelFor(NumExpanded, [&](int32 Index)
+	{
+		const int i = FirstSegment + Index;
+		for (int j = 0; j < RingSize; j++)
+		{
+			int p1 = i * RingSize;
+			int p2 = (i + 1) * RingSize;
+			int n = (j + 1) == RingSize ? 0 : (j + 1);
+			int q = (p1 + j) * 4;
+
+			const FVector& A = SweptPoints[p1 + j];
+			const FVector& B = SweptPoints[p2 + j];
+			const FVector& C = SweptPoints[p1 + n];
+			const FVector& D = SweptPoints[p2 + n];
+
+			SideVertices[q] = A;
+			SideVertices[q + 1] = B;
+			SideVertices[q + 2] = C;
+			SideVertices[q + 3] = D;
+
+			SideUVs[q] = SweptUVs[p1 + j];
+			SideUVs[q + 1] = SweptUVs[p2 + j];
+			SideUVs[q + 2] = (j + 1) == RingSize ? FVector2D(1, SweptUVs[p1 + n].Y) : SweptUVs[p1 + n];
+			SideUVs[q + 3] = (j + 1) == RingSize ? FVector2D(1, SweptUVs[p2 + n].Y) : SweptUVs[p2 + n];
+
+			//Calculate normal of triangles
+			FVector n1 = FVector::CrossProduct(B - A, C - A).GetSafeNormal();
+			FVector n2 = FVector::CrossProduct(B - C, D - C).GetSafeNormal();
+			FVector n3 = (n1 + n2) / 2;
+
+			SideNormals[q] = n1;
+			SideNormals[q + 1] = n3;
+			SideNormals[q + 2] = n3;
+			SideNormals[q + 3] = n2;
+
+			if (Settings.bGenerateTangents)
+			{
+				//U runs from A to C around profile,V from A to B along path
+				const FVector TangentX = C - A;
+				const FVector Bitangent = B - A;
+				SideTangents[q] = MakeTangent(TangentX, n1, Bitangent, Settings.bFlipTangentY);
+				SideTangents[q + 1] = MakeTangent(TangentX, n3, Bitangent, Settings.bFlipTangentY);
+				SideTangents[q + 2] = MakeTangent(TangentX, n3, Bitangent, Settings.bFlipTangentY);
+				SideTangents[q + 3] = MakeTangent(TangentX, n2, Bitangent, Settings.bFlipTangentY);
+			}
+		}
+	}, !Settings.ShouldRunInParallel(NumExpanded * RingSize * 4));
+}
+
+void FSplineSweepGenerator::SweepPointsAlongSpline(float Rate, FSplineSweepMeshBuffers& Buffers, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs, int FirstRing, int LastRing) const
+{
+	SPLINESWEEP_SCOPE(SweepPoints);
+	const int SegmentsNumber = GetNumSegments(Buffers);
+	const int RingSize = Profile.Num();
+	//Resize in place,one ring per segment and one at the end of path
+	Buffers.Resize(OutPoints, (SegmentsNumber + 1) * RingSize);
+	Buffers.Resize(OutNormal, (SegmentsNumber + 1) * RingSize);
+	Buffers.Resize(OutUVs, (SegmentsNumber + 1) * RingSize);
+	Buffers.Resize(Buffers.RingKeys, SegmentsNumber + 1);
+	if (Settings.bSmoothNormal)
+	{
+		ResizeSideTangents(Buffers);
+	}
+	if (RingSize == 0)
+	{
+		return;
+	}
+
+	const float SplineLength = Frames.GetSplineLength();
+	float SegmentLength = SplineLength*Rate / SegmentsNumber;
+	const bool bAdaptive = Settings.bAdaptiveSegments && Buffers.RingFractions.Num() == SegmentsNumber + 1;
+
+	//Every ring only depends on its own frame,so rings can be written into their slices from any thread
+	LastRing = LastRing == INDEX_NONE ? SegmentsNumber : FMath::Min(LastRing, SegmentsNumber);
+	const int NumSwept = FMath::Max(LastRing - FirstRing + 1, 0);
+	ParallelFor(NumSwept, [&](int32 Index)
+	{
+		const int i = FirstRing + Index;
+		//The last ring sits at the end of path,UV should be(u,1)
+		if (i == SegmentsNumber)
+		{
+			SweepRing(Frames.GetFrameAtDistance(SplineLength*Rate), 1, i, Buffers, OutPoints, OutNormal, OutUVs);
+		}
+		else
+		{
+			const float Distance = bAdaptive ? Buffers.RingFractions[i] * SplineLength*Rate : i * SegmentLength;
+			SweepRing(Frames.GetFrameAtDistance(Distance), Distance / SplineLength*Rate, i, Buffers, OutPoints, OutNormal, OutUVs);
+		}
+	}, !Settings.ShouldRunInParallel(NumSwept * RingSize));
+}
+
+int FSplineSweepGenerator::SweepPointsAtFixedSpacing(float Rate, FSplineSweepMeshBuffers& Buffers, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs, int& OutNumRings) const
+{
+	SPLINESWEEP_SCOPE(SweepPoints);
+	const int RingSize = Profile.Num();
+	const float SplineLength = Frames.GetSplineLength();
+	const float Spacing = SplineLength / FMath::Max(Settings.NumSegments, 1);
+	const float GrownLength = GetGrownLength(Rate);
+
+	//Rings at whole multiples of spacing,plus a partial ring at the tip if it is not on one of them
+	const int NumFixedRings = Spacing > 0 ? FMath::Min(FMath::FloorToInt(GrownLength / Spacing), Settings.NumSegments) + 1 : 1;
+	const bool bHasPartialRing = GrownLength > (NumFixedRings - 1) * Spacing;
+	OutNumRings = NumFixedRings + (bHasPartialRing ? 1 : 0);
+
+	//Fixed rings already in the buffers stay valid until path frames change
+	if (Buffers.FixedRingsFrameSerial != Frames.GetSerial() || OutPoints.Num() < Buffers.NumValidFixedRings * RingSize)
+	{
+		Buffers.NumValidFixedRings = 0;
+		Buffers.FixedRingsFrameSerial = Frames.GetSerial();
+	}
+	const int FirstRing = FMath::Min(Buffers.NumValidFixedRings, NumFixedRings);
+
+	//Growing keeps rings in front,trimming only drops the tail
+	Buffers.Resize(OutPoints, OutNumRings * RingSize);
+	Buffers.Resize(OutNormal, OutNumRings * RingSize);
+	Buffers.Resize(OutUVs, OutNumRings * RingSize);
+	Buffers.Resize(Buffers.RingKeys, OutNumRings);
+	if (Settings.bSmoothNormal)
+	{
+		ResizeSideTangents(Buffers);
+	}
+	Buffers.NumValidFixedRings = NumFixedRings;
+	if (RingSize == 0)
+	{
+		return FirstRing;
+	}
+
+	//V follows arc length,so texture does not stretch while growing
+	ParallelFor(OutNumRings - FirstRing, [&](int32 Index)
+	{
+		const int Ring = FirstRing + Index;
+		const float Distance = Ring < NumFixedRings ? Ring * Spacing : GrownLength;
+		SweepRing(Frames.GetFrameAtDistance(Distance), SplineLength > 0 ? Distance / SplineLength : 0, Ring, Buffers, OutPoints, OutNormal, OutUVs);
+	}, !Settings.ShouldRunInParallel((OutNumRings - FirstRing) * RingSize));
+
+	return FirstRing;
+}
+
+void FSplineSweepGenerator::SweepRing(const FSplineSweepFrame& Frame, float V, int Ring, FSplineSweepMeshBuffers& Buffers, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs) const
+{
+	const int RingSize = Profile.Num();
+	const int First = Ring * RingSize;
+	const FMatrix M = Frame.ToMatrix();
+	Buffers.RingKeys[Ring] = Frame.InputKey;
+
+	//Transform position and normal
+	if (Settings.bVectorized)
+	{
+		Profile.TransformRing(M, &OutPoints[First], &OutNormal[First]);
+	}
+	else
+	{
+		Profile.TransformRingScalar(M, &OutPoints[First], &OutNormal[First]);
+	}
+	for (int j = 0; j < RingSize; j++)
+	{
+		//U is precomputed with profile
+		OutUVs[First + j] = FVector2D(Profile.GetU(j), V);
+	}
+
+	//Rings are the side vertices if use smoothed normal,quads make their own tangents otherwise
+	if (Settings.bGenerateTangents && Settings.bSmoothNormal)
+	{
+		//U runs around profile and V along path,so tangent follows profile and binormal follows path
+		const FVector Forward = Frame.Rotation.GetAxisX();
+		FProcMeshTangent* OutTangents = &Buffers.SideTangents[First];
+		for (int j = 0; j < RingSize; j++)
+		{
+			OutTangents[j] = MakeTangent(M.TransformVector(Profile.GetDirection(j)), OutNormal[First + j], Forward, Settings.bFlipTangentY);
+		}
+	}
+}
+
+int FSplineSweepGenerator::UpdateDirtyRings(const FSplineSweepPathSnapshot& Path, const TArray<bool>& DirtySegments, FSplineSweepMeshBuffers& Buffers, int& OutFirstRing, int& OutLastRing) const
+{
+	SPLINESWEEP_SCOPE(SweepPoints);
+	TArray<FVector>& OutPoints = Settings.bSmoothNormal ? Buffers.SideVertices : Buffers.SweptPoints;
+	TArray<FVector>& OutNormals = Settings.bSmoothNormal ? Buffers.SideNormals : Buffers.SweptNormals;
+	TArray<FVector2D>& OutUVs = Settings.bSmoothNormal ? Buffers.SideUVs : Buffers.SweptUVs;
+	const int NumRings = Buffers.RingKeys.Num();
+
+	//Rings are sorted by key,so dirty rings of a segment are contiguous
+	OutFirstRing = INDEX_NONE;
+	OutLastRing = INDEX_NONE;
+	int NumDirty = 0;
+	for (int Ring = 0; Ring < NumRings; Ring++)
+	{
+		const int Segment = Path.GetSegmentAtInputKey(Buffers.RingKeys[Ring]);
+		if (!DirtySegments.IsValidIndex(Segment) || !DirtySegments[Segment])
+		{
+			continue;
+		}
+		//Keep V,texture stretches with the edited segment instead of sliding along the whole path
+		const FSplineSweepFrame Frame = FSplineSweepFrameCache::EvaluateFrameAtInputKey(Path.Curves, Path.DefaultUpVector, Buffers.RingKeys[Ring]);
+		SweepRing(Frame, OutUVs[Ring * Profile.Num()].Y, Ring, Buffers, OutPoints, OutNormals, OutUVs);
+
+		OutFirstRing = OutFirstRing == INDEX_NONE ? Ring : OutFirstRing;
+		OutLastRing = Ring;
+		NumDirty++;
+	}
+	if (NumDirty == 0)
+	{
+		return 0;
+	}
+
+	if (!Settings.bSmoothNormal)
+	{
+		//Quads on both sides of a dirty ring change
+		ExpandSweptPointsIntoQuads(Buffers, NumRings - 1, FMath::Max(OutFirstRing - 1, 0), OutLastRing);
+	}
+	if (Settings.bHaveCover && (OutFirstRing == 0 || OutLastRing == NumRings - 1))
+	{
+		const FMatrix M0 = FSplineSweepFrameCache::EvaluateFrameAtInputKey(Path.Curves, Path.DefaultUpVector, Buffers.RingKeys[0]).ToMatrix();
+		const FMatrix M1 = FSplineSweepFrameCache::EvaluateFrameAtInputKey(Path.Curves, Path.DefaultUpVector, Buffers.RingKeys[NumRings - 1]).ToMatrix();
+		BuildCoversAt(M0, M1, Buffers, false);
+	}
+	return NumDirty;
+}
@@ -59,11 +59,16 @@ ASplineSweepMeshActor::ASplineSweepMeshActor()
 void ASplineSweepMeshActor::OnConstruction(const FTransform& Transform)
 {
 	SplineToSweep->SetClosedLoop(true);
-	for (int i = 0; i < SplineToSweep->GetNumberOfSplinePoints(); i++)
+	if (!bCurvedProfile)
 	{
-		SplineToSweep->SetSplinePointType(i, ESplinePointType::Linear, false);
+		for (int i = 0; i < SplineToSweep->GetNumberOfSplinePoints(); i++)
+		{
+			SplineToSweep->SetSplinePointType(i, ESplinePointType::Linear, false);
+		}
+		SplineToSweep->UpdateSpline();
 	}
-	CreateSweepMesh();
+	//Sections saved with the level,or created by the last construction,are kept if nothing changed
+	SweepMeshComponent->CreateSweepMeshIfChanged(SplineToSweep, SplineAsPath, NumSegments, RateOfProgress, bUseSmoothNormal, bCreateCollision);
 	SweepMeshComponent->SetMaterial(0, SideMaterial);
 	SweepMeshComponent->SetMaterial(1, CoverMaterial);
 }
@@ -79,11 +84,23 @@ void ASplineSweepMeshActor::UpdatePathSpline(float Rate)
 	SweepMeshComponent->UpdatePathSpline(SplineAsPath,Rate);
 }
 
+void ASplineSweepMeshActor::UpdatePathSplineAsync(float Rate)
+{
+	RateOfProgress = Rate;
+	SweepMeshComponent->UpdatePathSplineAsync(SplineAsPath, Rate);
+}
+
+void ASplineSweepMeshActor::UpdatePathSplineScheduled(float Rate)
+{
+	RateOfProgress = Rate;
+	SweepMeshComponent->UpdatePathSplineScheduled(SplineAsPath, Rate);
+}
+
 // Called when the game starts or when spawned
 void ASplineSweepMeshActor::BeginPlay()
 {
 	Super::BeginPlay();
-	CreateSweepMesh();
+	SweepMeshComponent->CreateSweepMeshIfChanged(SplineToSweep, SplineAsPath, NumSegments, RateOfProgress, bUseSmoothNormal, bCreateCollision);
 }
 
 // Called every frame
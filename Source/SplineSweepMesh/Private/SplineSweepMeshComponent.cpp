@@ -4,452 +4,1282 @@
 #include "Components/SplineComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "KismetProceduralMeshLibrary.h"
+#include "Async/Async.h"
+#include "SplineSweepStats.h"
+#include "SplineSweepProfileCache.h"
+#include "SplineSweepUpdateSubsystem.h"
+#include "TimerManager.h"
 
-TrianglePoints::TrianglePoints(FVector A, FVector B, FVector C)
+void FSplineSweepAsyncBuild::Execute()
 {
+	SPLINESWEEP_SCOPE(AsyncBuild);
+	if (bCreate)
+	{
+		Profile = FSplineSweepProfileCache::Get().FindOrCreate(ProfilePoints, ProfileNormals, Settings.bHaveCover);
+	}
+	if (bRebuildFrames)
+	{
+		TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+		NewFrames->Build(PathSnapshot, FrameSamplesPerSegment, bRotationMinimizingFrames);
+		Frames = NewFrames;
+	}
 
-	pointA = A;
-	pointB = B;
-	pointC = C;
+	Buffers.Allocations = 0;
+	FSplineSweepGenerator(*Profile, *Frames, Settings).Build(Rate, Buffers, bCreate);
 }
 
-QuadPoints::QuadPoints(FVector A, FVector B, FVector C, FVector D, FVector2D UA, FVector2D UB, FVector2D UC, FVector2D UD)
+namespace SplineSweepMeshComponent
 {
-	pointA = A;
-	pointB = B;
-	pointC = C;
-	pointD = D;
-
+	//Levels are picked a few times per second,progressive builds tick every frame
+	const float LODTickInterval = 0.25f;
+}
 
-	UVa = UA;
-	UVb = UB;
-	UVc = UC;
-	UVd = UD;
+USplineSweepMeshComponent::USplineSweepMeshComponent()
+{
+	//Ticks to pick LODs,enabled when mesh is created with LODs,and to run progressive builds
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickInterval = SplineSweepMeshComponent::LODTickInterval;
+	bTickInEditor = true;
 }
 
+void USplineSweepMeshComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	//Levels are switched once the mesh is complete
+	if (ProgressiveBuild.IsSet())
+	{
+		StepProgressiveBuild();
+		return;
+	}
+
+	//Topology of a running build belongs to the current LOD,switch after it lands
+	if (LODs.Num() == 0 || IsAsyncBuildPending())
+	{
+		return;
+	}
+	const int DesiredLOD = ComputeDesiredLOD();
+	//Saved sections are kept until another level is wanted
+	if (DesiredLOD != ActiveLOD && RestoreSweepState())
+	{
+		SwitchLOD(DesiredLOD);
+	}
+}
 
 void USplineSweepMeshComponent::CreateSweepMesh(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, bool CreateCollision)
 {
+	const uint32 PathHash = PathSpline ? ComputePathHash(PathSpline, Rate) : 0;
+	const uint32 InputHash = PathSpline && SweepSpline ? ComputeInputHash(SweepSpline, segments, SmoothNormal, CreateCollision, PathHash) : 0;
+	//Construction scripts run again on every edit of the actor,most of them change nothing
+	if (bSkipUnchangedInputs && IsBuiltFrom(InputHash, false))
+	{
+		CountSkippedBuild();
+		return;
+	}
+	BuildSweepMesh(SweepSpline, PathSpline, segments, Rate, SmoothNormal, CreateCollision, PathHash, InputHash);
+}
+
+void USplineSweepMeshComponent::BuildSweepMesh(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, bool CreateCollision, uint32 PathHash, uint32 InputHash)
+{
+	SPLINESWEEP_SCOPE(CreateSweepMesh);
+	//Results of asynchronous builds,progressive builds and scheduled updates requested before are out of date now
+	CancelProgressiveBuild();
+	BuildGeneration++;
+	PendingAsyncRequest.Reset();
+	CancelScheduledUpdate();
+	SavedSectionsRequest.Reset();
+
 	//Clear procedural mesh sections
 	ClearAllMeshSections();
 	//Is valid
 	if (PathSpline && SweepSpline)
 	{
-		//Store points' info which will be used to sweep along path
-		SweepPoints = GetSplinePointsLocation(SweepSpline);
-		SweepPointNormals = GetSplinePointsNormal(SweepSpline);
+		SetupSweep(SweepSpline, PathSpline, segments, SmoothNormal, CreateCollision);
+		SetComponentTickEnabled(LODs.Num() > 0);
+
+		FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).Build(Rate, MeshBuffers, true);
+		LastRate = Rate;
+		ApplyCollisionMode();
+		CreateMeshSections();
+		CreateCollisionProxy(PathSpline, Rate);
+		//Loaded sections can only be reused if they are full detail
+		SectionsInputHash = ActiveLOD == 0 ? InputHash : 0;
+		BuiltInputHash = InputHash;
+		BuiltPathHash = PathHash;
+	}
+	else
+	{
+		SectionsInputHash = 0;
+		BuiltInputHash = 0;
+		BuiltPathHash = 0;
+	}
+}
 
-		bUseSmoothNormal = SmoothNormal;
-		NumSegments = segments;
-		CreateSideQuads(PathSpline, SweepSpline, segments,Rate, SmoothNormal, CreateCollision);
+void USplineSweepMeshComponent::SetupSweep(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, bool SmoothNormal, bool CreateCollision)
+{
+	SweepSettings.NumSegments = segments;
+	SweepSettings.bSmoothNormal = SmoothNormal;
+	//If is not closed loop,create covers 
+	SweepSettings.bHaveCover = !PathSpline->IsClosedLoop();
+	SweepSettings.bCreateCollision = CreateCollision;
+	ApplySegmentationSettings(SweepSettings);
+	ApplyPerformanceSettings(SweepSettings);
+
+	//Store points' info which will be used to sweep along path,components sweeping the same cross section share one profile
+	TArray<FVector> ProfilePoints;
+	TArray<FVector> ProfileNormals;
+	GetProfilePoints(SweepSpline, ProfilePoints, ProfileNormals);
+	BaseProfile = FSplineSweepProfileCache::Get().FindOrCreate(ProfilePoints, ProfileNormals, SweepSettings.bHaveCover);
+	BaseSettings = SweepSettings;
+	SweepPath = PathSpline;
+	//Keep the level picked for the mesh before,views are checked again on tick
+	ApplyLOD(ActiveLOD);
+	UpdatePathFrames(PathSpline);
+}
 
-		//If is closed loop,create covers 
-		if (!PathSpline->IsClosedLoop())
+bool USplineSweepMeshComponent::CreateSweepMeshIfChanged(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, bool CreateCollision)
+{
+	const uint32 PathHash = PathSpline ? ComputePathHash(PathSpline, Rate) : 0;
+	const uint32 InputHash = PathSpline && SweepSpline ? ComputeInputHash(SweepSpline, segments, SmoothNormal, CreateCollision, PathHash) : 0;
+	if (IsBuiltFrom(InputHash, true))
+	{
+		CountSkippedBuild();
+		//Saved sections have nothing to update from,remember how to create them for the first update
+		if (!HasSweepState())
 		{
-			CreateCoverTriangles(PathSpline, SweepSpline,Rate, CreateCollision);
-			bHaveCover = true;
+			FPendingSweepRequest Request;
+			Request.bCreate = true;
+			Request.SweepSpline = SweepSpline;
+			Request.PathSpline = PathSpline;
+			Request.NumberOfSegments = segments;
+			Request.Rate = Rate;
+			Request.bSmoothNormal = SmoothNormal;
+			Request.bCreateCollision = CreateCollision;
+			SavedSectionsRequest = Request;
+			SetComponentTickEnabled(LODs.Num() > 0);
 		}
-		else
+		return false;
+	}
+	BuildSweepMesh(SweepSpline, PathSpline, segments, Rate, SmoothNormal, CreateCollision, PathHash, InputHash);
+	return true;
+}
+
+bool USplineSweepMeshComponent::RestoreSweepState()
+{
+	if (HasSweepState())
+	{
+		return true;
+	}
+	if (!SavedSectionsRequest.IsSet())
+	{
+		return false;
+	}
+	const FPendingSweepRequest Request = SavedSectionsRequest.GetValue();
+	USplineComponent* SweepSpline = Request.SweepSpline.Get();
+	USplineComponent* PathSpline = Request.PathSpline.Get();
+	if (!SweepSpline || !PathSpline)
+	{
+		SavedSectionsRequest.Reset();
+		return false;
+	}
+	//Splines may have been edited since the sections were saved,hash them as they are now
+	const uint32 PathHash = ComputePathHash(PathSpline, Request.Rate);
+	const uint32 InputHash = ComputeInputHash(SweepSpline, Request.NumberOfSegments, Request.bSmoothNormal, Request.bCreateCollision, PathHash);
+	BuildSweepMesh(SweepSpline, PathSpline, Request.NumberOfSegments, Request.Rate, Request.bSmoothNormal, Request.bCreateCollision, PathHash, InputHash);
+	return HasSweepState();
+}
+
+bool USplineSweepMeshComponent::IsBuiltFrom(uint32 InputHash, bool bAllowSavedSections) const
+{
+	if (InputHash == 0 || GetNumSections() == 0 || IsAsyncBuildPending() || IsProgressiveBuildPending())
+	{
+		return false;
+	}
+	return (HasSweepState() && InputHash == BuiltInputHash) || (bAllowSavedSections && InputHash == SectionsInputHash);
+}
+
+bool USplineSweepMeshComponent::IsBuiltAlong(USplineComponent* Path, uint32 PathHash) const
+{
+	return PathHash == BuiltPathHash && SweepPath.Get() == Path && GetNumSections() > 0 && !IsAsyncBuildPending() && !IsProgressiveBuildPending();
+}
+
+void USplineSweepMeshComponent::CountSkippedBuild()
+{
+	NumSkippedBuilds++;
+	INC_DWORD_STAT(STAT_SplineSweep_SkippedBuilds);
+	//A queued update would move sections away from the inputs just requested
+	CancelScheduledUpdate();
+}
+
+void USplineSweepMeshComponent::CancelScheduledUpdate()
+{
+	if (USplineSweepUpdateSubsystem* Scheduler = GetWorld() ? GetWorld()->GetSubsystem<USplineSweepUpdateSubsystem>() : nullptr)
+	{
+		Scheduler->CancelUpdate(this);
+	}
+}
+
+namespace SplineSweepMeshComponent
+{
+	//Change when generated geometry changes for the same inputs,so sections saved by older versions are created again
+	const uint32 InputHashVersion = 3;
+
+	template<typename T>
+	uint32 HashValue(const T& Value, uint32 Hash)
+	{
+		return FCrc::MemCrc32(&Value, sizeof(T), Hash);
+	}
+
+	template<typename T>
+	uint32 HashCurve(const FInterpCurve<T>& Curve, uint32 Hash)
+	{
+		//Field by field,points have padding
+		for (const FInterpCurvePoint<T>& Point : Curve.Points)
 		{
-			bHaveCover = false;
+			Hash = HashValue(Point.InVal, Hash);
+			Hash = HashValue(Point.OutVal, Hash);
+			Hash = HashValue(Point.ArriveTangent, Hash);
+			Hash = HashValue(Point.LeaveTangent, Hash);
+			Hash = HashValue(uint8(Point.InterpMode), Hash);
 		}
+		Hash = HashValue(Curve.bIsLooped, Hash);
+		return HashValue(Curve.LoopKeyOffset, Hash);
+	}
+}
+
+uint32 USplineSweepMeshComponent::ComputeInputHash(USplineComponent* SweepSpline, int segments, bool SmoothNormal, bool CreateCollision, uint32 PathHash) const
+{
+	using namespace SplineSweepMeshComponent;
+	SPLINESWEEP_SCOPE(HashInputs);
+
+	uint32 Hash = HashValue(InputHashVersion, PathHash);
+	//Profile only reads positions and directions of spline to sweep
+	Hash = HashCurve(SweepSpline->SplineCurves.Position, Hash);
+	Hash = HashValue(segments, Hash);
+	Hash = HashValue(SmoothNormal, Hash);
+	Hash = HashValue(CreateCollision, Hash);
+	Hash = HashValue(CollisionMode, Hash);
+	Hash = HashValue(CollisionSegments, Hash);
+	Hash = HashValue(CollisionProfilePoints, Hash);
+	Hash = HashValue(MaxProfileDeviation, Hash);
+	Hash = HashValue(ChunkSegments, Hash);
+	//Levels are picked on tick,a create only keeps the active one
+	for (const FSplineSweepLOD& LOD : LODs)
+	{
+		Hash = HashValue(LOD.Threshold, Hash);
+		Hash = HashValue(LOD.SegmentFraction, Hash);
+		Hash = HashValue(LOD.ProfileFraction, Hash);
 	}
+	Hash = HashValue(LODMetric, Hash);
+	//0 is used for sections that were not created from known inputs
+	return Hash != 0 ? Hash : 1;
+}
+
+uint32 USplineSweepMeshComponent::ComputePathHash(USplineComponent* PathSpline, float Rate) const
+{
+	using namespace SplineSweepMeshComponent;
+	SPLINESWEEP_SCOPE(HashInputs);
+
+	//Transform of path is not read,vertices are in local space of path
+	uint32 Hash = HashCurve(PathSpline->SplineCurves.Position, 0);
+	Hash = HashCurve(PathSpline->SplineCurves.Rotation, Hash);
+	Hash = HashCurve(PathSpline->SplineCurves.Scale, Hash);
+	Hash = HashValue(PathSpline->GetDefaultUpVector(ESplineCoordinateSpace::Local), Hash);
+	Hash = HashValue(Rate, Hash);
+	Hash = HashValue(GrowthMode, Hash);
+	Hash = HashValue(SegmentMode, Hash);
+	Hash = HashValue(MaxChordDeviation, Hash);
+	Hash = HashValue(MaxSegmentAngle, Hash);
+	Hash = HashValue(MinAdaptiveSegments, Hash);
+	Hash = HashValue(MaxAdaptiveSegments, Hash);
+	Hash = HashValue(FrameCacheSamplesPerSegment, Hash);
+	Hash = HashValue(bRotationMinimizingFrames, Hash);
+	Hash = HashValue(bGenerateTangents, Hash);
+	Hash = HashValue(bFlipTangentY, Hash);
+	return Hash != 0 ? Hash : 1;
 }
 
 void USplineSweepMeshComponent::UpdatePathSpline(USplineComponent* path, float Rate)
 {
-	UpdateSideQuads(path,Rate);
-	if (bHaveCover)
+	//An older update still queued with the update subsystem would overwrite this one
+	CancelScheduledUpdate();
+	ApplyPathUpdate(path, Rate);
+}
+
+void USplineSweepMeshComponent::ApplyPathUpdate(USplineComponent* path, float Rate)
+{
+	//Mesh is not complete yet,chunks are kept and the update is applied once every chunk is created
+	if (path && ProgressiveBuild.IsSet())
+	{
+		ProgressiveBuild->bUpdatePending = true;
+		ProgressiveBuild->UpdatePath = path;
+		ProgressiveBuild->UpdateRate = Rate;
+		return;
+	}
+	if (!path || !RestoreSweepState())
+	{
+		return;
+	}
+	//Animations holding their rate and ticks with still paths update to the same mesh
+	const uint32 PathHash = ComputePathHash(path, Rate);
+	if (bSkipUnchangedInputs && IsBuiltAlong(path, PathHash))
 	{
-		UpdateCoverTriangles(path,Rate);
+		CountSkippedBuild();
+		return;
 	}
+
+	SPLINESWEEP_SCOPE(UpdatePathSpline);
+	//Results of asynchronous builds requested before would overwrite this update when they land
+	BuildGeneration++;
+	PendingAsyncRequest.Reset();
+	ApplyPerformanceSettings(SweepSettings);
+	SweepPath = path;
+	MeshBuffers.Allocations = 0;
+	DirtyFirstRing = 0;
+	DirtyLastRing = INDEX_NONE;
+	if (!UpdateEditedSegments(path, Rate))
+	{
+		//Rate only updates keep the cached frames
+		UpdatePathFrames(path);
+		FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).Build(Rate, MeshBuffers, false);
+		LastRate = Rate;
+	}
+	LastUpdateAllocations = MeshBuffers.Allocations;
+	UpdateMeshSections();
+	RequestCollisionUpdate(path, Rate);
+	SectionsInputHash = 0;
+	BuiltInputHash = 0;
+	BuiltPathHash = PathHash;
 }
 
-void USplineSweepMeshComponent::CreateSideQuads(USplineComponent* PathSpline, USplineComponent* SweepSpline, int SegmentsNumber, float Rate, bool bSmooth, bool CreateCollision)
+void USplineSweepMeshComponent::UpdatePathSplineScheduled(USplineComponent* path, float Rate)
 {
-	TArray<FVector> SidePoints;
-	TArray<FVector> PointNormals;
-	TArray<FVector2D> SideUVs;
+	UWorld* World = GetWorld();
+	USplineSweepUpdateSubsystem* Scheduler = World ? World->GetSubsystem<USplineSweepUpdateSubsystem>() : nullptr;
+	if (!Scheduler)
+	{
+		UpdatePathSpline(path, Rate);
+		return;
+	}
+	Scheduler->RequestUpdate(this, path, Rate);
+}
 
-	//Use  SweepPoints and SweepPointNormals to sweep along path to create side points 
-	SweepPointsAlongSpline(PathSpline, SweepPoints, SweepPointNormals, SegmentsNumber, Rate,SidePoints, PointNormals, SideUVs);
+bool USplineSweepMeshComponent::UpdateEditedSegments(USplineComponent* Path, float Rate)
+{
+	//Rings are placed by arc length or tolerance of the whole path,moving them needs a full update.Rotation minimizing frames depend on every frame before them
+	if (!bIncrementalPathEdits || bRotationMinimizingFrames || SweepSettings.bFixedSpacingGrowth || SweepSettings.bAdaptiveSegments || Rate != LastRate || !PathFrames.IsValid()
+		|| BuiltPathSnapshot.Path != Path || MeshBuffers.RingKeys.Num() == 0)
+	{
+		return false;
+	}
+	if (PathFrames->IsUpToDate(Path, FrameCacheSamplesPerSegment, bRotationMinimizingFrames))
+	{
+		return false;
+	}
 
-	//Parameters used to create procedural mesh 
-	TArray<FVector> vertices;
-	TArray<int> indices;
-	TArray<FVector> normals;
-	TArray<FVector2D> UVs;
-	TArray<FColor> color;
-	TArray<FProcMeshTangent> tangent;
+	FSplineSweepPathSnapshot Snapshot;
+	Snapshot.Capture(Path);
+	TArray<bool> DirtySegments;
+	if (!Snapshot.FindChangedSegments(BuiltPathSnapshot, DirtySegments))
+	{
+		return false;
+	}
 
-	//Branch if use smoothed normal
-	if (bSmooth)
+	//Cached frames stay out of date,the next full update rebuilds them
+	int FirstRing, LastRing;
+	const int NumDirty = FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).UpdateDirtyRings(Snapshot, DirtySegments, MeshBuffers, FirstRing, LastRing);
+	BuiltPathSnapshot = MoveTemp(Snapshot);
+	//Only chunks holding these rings are uploaded
+	DirtyFirstRing = NumDirty > 0 ? FirstRing : 0;
+	DirtyLastRing = NumDirty > 0 ? LastRing : -1;
+	return true;
+}
+
+void USplineSweepMeshComponent::CreateSweepMeshAsync(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, bool CreateCollision)
+{
+	if (PathSpline && SweepSpline)
 	{
-		vertices = SidePoints;
-		normals = PointNormals;
-		UVs = SideUVs;
+		const uint32 PathHash = ComputePathHash(PathSpline, Rate);
+		const uint32 InputHash = ComputeInputHash(SweepSpline, segments, SmoothNormal, CreateCollision, PathHash);
+		if (bSkipUnchangedInputs && IsBuiltFrom(InputHash, false))
+		{
+			CountSkippedBuild();
+			return;
+		}
+		CancelProgressiveBuild();
+
+		FPendingSweepRequest Request;
+		Request.bCreate = true;
+		Request.SweepSpline = SweepSpline;
+		Request.PathSpline = PathSpline;
+		Request.NumberOfSegments = segments;
+		Request.Rate = Rate;
+		Request.bSmoothNormal = SmoothNormal;
+		Request.bCreateCollision = CreateCollision;
+		Request.InputHash = InputHash;
+		Request.PathHash = PathHash;
+		RequestAsyncBuild(Request);
+	}
+}
 
-		//Create triangles
-		for (int i = 0; i < SegmentsNumber; i++)
+void USplineSweepMeshComponent::UpdatePathSplineAsync(USplineComponent* path, float Rate)
+{
+	CancelScheduledUpdate();
+	if (path && ProgressiveBuild.IsSet())
+	{
+		UpdatePathSpline(path, Rate);
+		return;
+	}
+	if (path)
+	{
+		const uint32 PathHash = ComputePathHash(path, Rate);
+		if (bSkipUnchangedInputs && IsBuiltAlong(path, PathHash))
 		{
-			for (int j = 0; j < SweepPoints.Num(); j++)
-			{
-				int p1 = i * SweepPoints.Num();
-				int p2 = (i + 1) * SweepPoints.Num();
-				int n = (j + 1) == SweepPoints.Num() ? 0 : (j + 1);
-
-				indices.Add(p1 + j);
-				indices.Add(p1 + n);
-				indices.Add(p2 + j);
-				indices.Add(p1 + n);
-				indices.Add(p2 + n);
-				indices.Add(p2 + j);
-			}
+			CountSkippedBuild();
+			return;
 		}
 
+		FPendingSweepRequest Request;
+		Request.PathSpline = path;
+		Request.Rate = Rate;
+		Request.PathHash = PathHash;
+		RequestAsyncBuild(Request);
+	}
+}
+
+void USplineSweepMeshComponent::RequestAsyncBuild(const FPendingSweepRequest& Request)
+{
+	if (!bAsyncBuildInFlight)
+	{
+		LaunchAsyncBuild(Request);
+		return;
+	}
+
+	//Merge with the request already waiting,an update must not drop a create that has not been built yet
+	if (!Request.bCreate && PendingAsyncRequest.IsSet() && PendingAsyncRequest->bCreate)
+	{
+		PendingAsyncRequest->PathSpline = Request.PathSpline;
+		PendingAsyncRequest->Rate = Request.Rate;
+		PendingAsyncRequest->PathHash = Request.PathHash;
+		//The create is no longer built from the inputs it was hashed with
+		PendingAsyncRequest->InputHash = 0;
 	}
 	else
 	{
-		//Convert side points into quad
-		TArray<QuadPoints> SideQuad;
-		for (int i = 0; i < SegmentsNumber; i++)
+		PendingAsyncRequest = Request;
+	}
+}
+
+void USplineSweepMeshComponent::LaunchAsyncBuild(const FPendingSweepRequest& Request)
+{
+	USplineComponent* PathSpline = Request.PathSpline.Get();
+	USplineComponent* SweepSpline = Request.SweepSpline.Get();
+	if (!PathSpline || (Request.bCreate && !SweepSpline) || (!Request.bCreate && !RestoreSweepState()))
+	{
+		return;
+	}
+
+	if (!AsyncBuild.IsValid())
+	{
+		AsyncBuild = MakeShared<FSplineSweepAsyncBuild, ESPMode::ThreadSafe>();
+	}
+	FSplineSweepAsyncBuild& Build = *AsyncBuild;
+	Build.bCreate = Request.bCreate;
+	Build.Rate = Request.Rate;
+	Build.Generation = BuildGeneration;
+	Build.PathSpline = Request.PathSpline;
+	Build.InputHash = Request.InputHash;
+	Build.PathHash = Request.PathHash;
+
+	//Capture everything the worker needs,it must not touch any UObject
+	if (Request.bCreate)
+	{
+		Build.Settings.NumSegments = Request.NumberOfSegments;
+		Build.Settings.bSmoothNormal = Request.bSmoothNormal;
+		Build.Settings.bHaveCover = !PathSpline->IsClosedLoop();
+		Build.Settings.bCreateCollision = Request.bCreateCollision;
+		ApplySegmentationSettings(Build.Settings);
+		GetProfilePoints(SweepSpline, Build.ProfilePoints, Build.ProfileNormals);
+		Build.Profile.Reset();
+	}
+	else
+	{
+		Build.Settings = SweepSettings;
+		Build.Profile = SweepProfile;
+	}
+	ApplyPerformanceSettings(Build.Settings);
+
+	Build.FrameSamplesPerSegment = FrameCacheSamplesPerSegment;
+	Build.bRotationMinimizingFrames = bRotationMinimizingFrames;
+	Build.bRebuildFrames = !PathFrames.IsValid() || !PathFrames->IsUpToDate(PathSpline, FrameCacheSamplesPerSegment, bRotationMinimizingFrames);
+	if (Build.bRebuildFrames)
+	{
+		Build.PathSnapshot.Capture(PathSpline);
+	}
+	else
+	{
+		Build.Frames = PathFrames;
+	}
+
+	bAsyncBuildInFlight = true;
+	TSharedPtr<FSplineSweepAsyncBuild, ESPMode::ThreadSafe> BuildRef = AsyncBuild;
+	TWeakObjectPtr<USplineSweepMeshComponent> WeakThis(this);
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [BuildRef, WeakThis]()
+	{
+		BuildRef->Execute();
+		AsyncTask(ENamedThreads::GameThread, [WeakThis]()
 		{
-			for (int j = 0; j < SweepPoints.Num(); j++)
+			if (USplineSweepMeshComponent* Component = WeakThis.Get())
 			{
-				int p1 = i * SweepPoints.Num();
-				int p2 = (i + 1) * SweepPoints.Num();
-				int n = (j + 1) == SweepPoints.Num() ? 0 : (j + 1);
-				FVector2D UVc = (j + 1) == SweepPoints.Num() ? FVector2D(1, SideUVs[p1 + n].Y) : SideUVs[p1 + n];
-				FVector2D UVd = (j + 1) == SweepPoints.Num() ? FVector2D(1, SideUVs[p2 + n].Y) : SideUVs[p2 + n];
+				Component->FinishAsyncBuild();
+			}
+		});
+	});
+}
+
+void USplineSweepMeshComponent::FinishAsyncBuild()
+{
+	bAsyncBuildInFlight = false;
+	FSplineSweepAsyncBuild& Build = *AsyncBuild;
+
+	//Drop results made out of date by a synchronous build
+	if (Build.Generation == BuildGeneration)
+	{
+		SweepProfile = Build.Profile;
+		PathFrames = Build.Frames;
+		SweepSettings = Build.Settings;
+		SweepPath = Build.PathSpline;
+		LastUpdateAllocations = Build.Buffers.Allocations;
+		LastRate = Build.Rate;
+		if (Build.bRebuildFrames)
+		{
+			BuiltPathSnapshot = Build.PathSnapshot;
+		}
 
-				QuadPoints quad = QuadPoints(SidePoints[p1 + j], SidePoints[p2 + j], SidePoints[p1 + n], SidePoints[p2 + n],
-					SideUVs[p1 + j], SideUVs[p2 + j], UVc, UVd);
-				SideQuad.Add(quad);
+		//Old front buffers become the next back buffer.Fixed spacing growth and adaptive segments may change indices on any update
+		if (Build.bCreate)
+		{
+			MeshBuffers.SwapAll(Build.Buffers);
+			ClearAllMeshSections();
+			//Asynchronous creates are built at full detail
+			BaseProfile = Build.Profile;
+			BaseSettings = Build.Settings;
+			ActiveLOD = 0;
+			SetComponentTickEnabled(LODs.Num() > 0);
+			ApplyCollisionMode();
+			CreateMeshSections();
+			CreateCollisionProxy(Build.PathSpline.Get(), Build.Rate);
+			SectionsInputHash = Build.InputHash;
+			BuiltInputHash = Build.InputHash;
+		}
+		else
+		{
+			if (SweepSettings.bFixedSpacingGrowth || SweepSettings.bAdaptiveSegments)
+			{
+				MeshBuffers.SwapAll(Build.Buffers);
+			}
+			else
+			{
+				MeshBuffers.SwapVertexData(Build.Buffers);
+			}
+			DirtyFirstRing = 0;
+			DirtyLastRing = INDEX_NONE;
+			UpdateMeshSections();
+			RequestCollisionUpdate(Build.PathSpline.Get(), Build.Rate);
+			SectionsInputHash = 0;
+			BuiltInputHash = 0;
+		}
+		BuiltPathHash = Build.PathHash;
+	}
+	//Shared data is held by the component now
+	Build.Frames.Reset();
+	Build.Profile.Reset();
+
+	if (PendingAsyncRequest.IsSet())
+	{
+		FPendingSweepRequest Request = PendingAsyncRequest.GetValue();
+		PendingAsyncRequest.Reset();
+		LaunchAsyncBuild(Request);
+	}
+}
+
+void USplineSweepMeshComponent::CreateSweepMeshProgressive(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, bool CreateCollision)
+{
+	if (!PathSpline || !SweepSpline)
+	{
+		return;
+	}
+	const uint32 PathHash = ComputePathHash(PathSpline, Rate);
+	const uint32 InputHash = ComputeInputHash(SweepSpline, segments, SmoothNormal, CreateCollision, PathHash);
+	//The running build is already working towards these inputs
+	if (ProgressiveBuild.IsSet() && ProgressiveBuild->InputHash == InputHash && ProgressiveBuild->SweepSpline.Get() == SweepSpline && ProgressiveBuild->PathSpline.Get() == PathSpline)
+	{
+		return;
+	}
+	if (bSkipUnchangedInputs && IsBuiltFrom(InputHash, false))
+	{
+		CountSkippedBuild();
+		OnProgressiveBuildFinished.Broadcast(this);
+		return;
+	}
+
+	//Results of asynchronous builds and scheduled updates requested before are out of date now
+	BuildGeneration++;
+	PendingAsyncRequest.Reset();
+	CancelScheduledUpdate();
+
+	//A running progressive build starts over with the new inputs
+	FProgressiveBuildState Build;
+	Build.SweepSpline = SweepSpline;
+	Build.PathSpline = PathSpline;
+	Build.NumberOfSegments = segments;
+	Build.Rate = Rate;
+	Build.bSmoothNormal = SmoothNormal;
+	Build.bCreateCollision = CreateCollision;
+	Build.InputHash = InputHash;
+	Build.PathHash = PathHash;
+	ProgressiveBuild = Build;
+	//Steps run on tick from the next frame on
+	SetComponentTickInterval(0);
+	SetComponentTickEnabled(true);
+}
+
+void USplineSweepMeshComponent::CancelProgressiveBuild()
+{
+	if (!ProgressiveBuild.IsSet())
+	{
+		return;
+	}
+	EndProgressiveBuild();
+	//Sections created so far are not built from known inputs
+	SectionsInputHash = 0;
+	BuiltInputHash = 0;
+	BuiltPathHash = 0;
+	OnProgressiveBuildCancelled.Broadcast(this);
+}
+
+float USplineSweepMeshComponent::GetProgressiveBuildProgress() const
+{
+	if (!ProgressiveBuild.IsSet())
+	{
+		return 1;
+	}
+	return ProgressiveBuild->bPrepared && ProgressiveBuild->NumChunks > 0 ? float(ProgressiveBuild->NextChunk) / ProgressiveBuild->NumChunks : 0;
+}
+
+void USplineSweepMeshComponent::StepProgressiveBuild()
+{
+	SPLINESWEEP_SCOPE(ProgressiveBuild);
+	FProgressiveBuildState& Build = ProgressiveBuild.GetValue();
+	USplineComponent* SweepSpline = Build.SweepSpline.Get();
+	USplineComponent* PathSpline = Build.PathSpline.Get();
+	if (!SweepSpline || !PathSpline)
+	{
+		CancelProgressiveBuild();
+		return;
+	}
 
+	//Chunks created before spline to sweep was edited are out of date,start over.Path edits are applied as an update once the mesh is complete
+	if (Build.bPrepared && SweepSpline->SplineCurves.Version != Build.SweepVersion)
+	{
+		Build.SweepVersion = SweepSpline->SplineCurves.Version;
+		const uint32 InputHash = ComputeInputHash(SweepSpline, Build.NumberOfSegments, Build.bSmoothNormal, Build.bCreateCollision, Build.PathHash);
+		if (InputHash != Build.InputHash)
+		{
+			//Starting over anyway,so the requested update is built right away
+			if (Build.bUpdatePending && Build.UpdatePath.IsValid())
+			{
+				Build.PathSpline = Build.UpdatePath;
+				Build.Rate = Build.UpdateRate;
+				PathSpline = Build.UpdatePath.Get();
 			}
+			Build.bUpdatePending = false;
+			Build.PathHash = ComputePathHash(PathSpline, Build.Rate);
+			Build.InputHash = ComputeInputHash(SweepSpline, Build.NumberOfSegments, Build.bSmoothNormal, Build.bCreateCollision, Build.PathHash);
+			Build.bPrepared = false;
+		}
+	}
+
+	const double Deadline = FPlatformTime::Seconds() + ProgressiveBudgetMilliseconds / 1000.0;
+	//At least one step every frame,so a budget smaller than one chunk still makes progress
+	do
+	{
+		if (!Build.bPrepared)
+		{
+			PrepareProgressiveBuild(SweepSpline, PathSpline);
 		}
-		for (int i = 0; i < SideQuad.Num(); i++)
+		else if (Build.NextChunk < Build.NumChunks)
 		{
-			QuadPoints quad = SideQuad[i];
-
-			vertices.Add(quad.pointA);
-			vertices.Add(quad.pointB);
-			vertices.Add(quad.pointC);
-			vertices.Add(quad.pointD);
-
-			UVs.Add(quad.UVa);
-			UVs.Add(quad.UVb);
-			UVs.Add(quad.UVc);
-			UVs.Add(quad.UVd);
-
-			indices.Add(i * 4);
-			indices.Add(i * 4 + 2);
-			indices.Add(i * 4 + 1);
-			indices.Add(i * 4 + 2);
-			indices.Add(i * 4 + 3);
-			indices.Add(i * 4 + 1);
-
-			//Calculate normal of triangles
-			FVector n1 = UKismetMathLibrary::Cross_VectorVector(quad.pointB - quad.pointA, quad.pointC - quad.pointA).GetSafeNormal();
-			FVector n2 = UKismetMathLibrary::Cross_VectorVector(quad.pointB - quad.pointC, quad.pointD - quad.pointC).GetSafeNormal();
-			FVector n3 = (n1 + n2) / 2;
-
-			normals.Add(n1);
-			normals.Add(n3);
-			normals.Add(n3);
-			normals.Add(n2);
+			const int FirstSegment = Build.NextChunk * ActiveChunkSegments;
+			const int LastSegment = FMath::Min(FirstSegment + ActiveChunkSegments, Build.NumSegments) - 1;
+			FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).BuildSideSegments(Build.Rate, MeshBuffers, FirstSegment, LastSegment);
+			SPLINESWEEP_SCOPE(CreateMeshSection);
+			//Without covers the last chunk cooks collision of the whole side surface
+			CreateSideChunkSection(Build.NextChunk, UsesRenderCollision(), !SweepSettings.bHaveCover && Build.NextChunk == Build.NumChunks - 1);
+			Build.NextChunk++;
+		}
+		else
+		{
+			FinishProgressiveBuild(PathSpline);
+			return;
 		}
 	}
-	CreateMeshSection(0, vertices, indices, normals, UVs, color, tangent, CreateCollision);
+	while (FPlatformTime::Seconds() < Deadline);
+}
 
+void USplineSweepMeshComponent::PrepareProgressiveBuild(USplineComponent* SweepSpline, USplineComponent* PathSpline)
+{
+	FProgressiveBuildState& Build = ProgressiveBuild.GetValue();
+	ClearAllMeshSections();
+	//Collision proxy of the older mesh must not be rebuilt into the new sections,a new one is made when the build finishes
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(CollisionUpdateTimer);
+	}
+	CollisionProfile.Reset();
+	SetupSweep(SweepSpline, PathSpline, Build.NumberOfSegments, Build.bSmoothNormal, Build.bCreateCollision);
+	//Chunks are created with collision of this mode
+	ApplyCollisionMode();
+	MeshBuffers.Allocations = 0;
+	//Side surface is always split,its chunks are the steps of the build
+	ActiveChunkSegments = ChunkSegments > 0 ? ChunkSegments : FMath::Max(ProgressiveChunkSegments, 1);
+	Build.NumSegments = FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).PrepareSide(Build.Rate, MeshBuffers);
+	Build.NumChunks = GetNumSideChunks();
+	Build.NextChunk = 0;
+	Build.bPrepared = true;
+	Build.SweepVersion = SweepSpline->SplineCurves.Version;
+	Build.PathVersion = PathSpline->SplineCurves.Version;
+	SideChunks.SetNum(Build.NumChunks);
+	SectionsInputHash = 0;
+	BuiltInputHash = 0;
+	BuiltPathHash = 0;
 }
 
-void USplineSweepMeshComponent::CreateCoverTriangles(USplineComponent* PathSpline, USplineComponent* SweepSpline, float Rate, bool CreateCollision)
+void USplineSweepMeshComponent::FinishProgressiveBuild(USplineComponent* PathSpline)
 {
-	//Function "ConvertSplineIntoTriangle" would remove points in array to create triangles,copy SweepPoints to prevent it from being removed
-	TArray<FVector> TemPoints = SweepPoints;
-	CoverTriangles = ConvertSplineIntoTriangle(TemPoints);
+	const FProgressiveBuildState Build = ProgressiveBuild.GetValue();
+	if (SweepSettings.bHaveCover)
+	{
+		FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).BuildCovers(Build.Rate, MeshBuffers, true);
+		SPLINESWEEP_SCOPE(CreateMeshSection);
+		//Cooks collision of side chunks too
+		CreateMeshSection(1, MeshBuffers.CoverVertices, MeshBuffers.CoverIndices, MeshBuffers.CoverNormals, EmptyUVs, EmptyColors, MeshBuffers.CoverTangents, UsesRenderCollision());
+	}
+	MeshBuffers.UpdateMemoryStat();
+	LastRate = Build.Rate;
+	CreateCollisionProxy(PathSpline, Build.Rate);
+	//Settings are not hashed while building,sections only count as built from the inputs if none changed
+	USplineComponent* SweepSpline = Build.SweepSpline.Get();
+	const bool bSameInputs = SweepSpline && ComputeInputHash(SweepSpline, Build.NumberOfSegments, Build.bSmoothNormal, Build.bCreateCollision, Build.PathHash) == Build.InputHash;
+	//Loaded sections can only be reused if they are full detail
+	SectionsInputHash = bSameInputs && ActiveLOD == 0 ? Build.InputHash : 0;
+	BuiltInputHash = bSameInputs ? Build.InputHash : 0;
+	BuiltPathHash = Build.PathHash;
+
+	EndProgressiveBuild();
+	//Path edited or updated while building
+	USplineComponent* UpdatePath = Build.bUpdatePending ? Build.UpdatePath.Get() : PathSpline;
+	if (UpdatePath && (Build.bUpdatePending || PathSpline->SplineCurves.Version != Build.PathVersion))
+	{
+		UpdatePathSpline(UpdatePath, Build.bUpdatePending ? Build.UpdateRate : Build.Rate);
+	}
+	OnProgressiveBuildFinished.Broadcast(this);
+}
 
-	//Parameters used to create procedural mesh 
-	TArray<FVector> vertices;
-	TArray<int> indices;
-	TArray<FVector> normals;
-	TArray<FVector2D> UVs;
-	TArray<FColor> color;
-	TArray<FProcMeshTangent> tangents;
-
-	//Create covers 
-	for (int i = 0; i < CoverTriangles.Num(); i++)
-	{
-		//Transform matrix at start and end of path
-		FMatrix M0 = GetMatrixInSplineDistance(PathSpline, 0);
-		FMatrix M1 = GetMatrixInSplineDistance(PathSpline, PathSpline->GetSplineLength()*Rate);
-
-		//Transform location of points into start and end of path 
-		FVector A0 = UKismetMathLibrary::Matrix_TransformPosition(M0, CoverTriangles[i].pointA);
-		FVector B0 = UKismetMathLibrary::Matrix_TransformPosition(M0, CoverTriangles[i].pointB);
-		FVector C0 = UKismetMathLibrary::Matrix_TransformPosition(M0, CoverTriangles[i].pointC);
-		FVector A1 = UKismetMathLibrary::Matrix_TransformPosition(M1, CoverTriangles[i].pointA);
-		FVector B1 = UKismetMathLibrary::Matrix_TransformPosition(M1, CoverTriangles[i].pointB);
-		FVector C1 = UKismetMathLibrary::Matrix_TransformPosition(M1, CoverTriangles[i].pointC);
-
-		vertices.Add(A0);
-		vertices.Add(C0);
-		vertices.Add(B0);
-		vertices.Add(A1);
-		vertices.Add(B1);
-		vertices.Add(C1);
-
-		indices.Add(i * 6);
-		indices.Add(i * 6 + 1);
-		indices.Add(i * 6 + 2);
-		indices.Add(i * 6 + 3);
-		indices.Add(i * 6 + 4);
-		indices.Add(i * 6 + 5);
-
-		//Calculate triangle's normal
-		FVector n0 = UKismetMathLibrary::Cross_VectorVector(B0 - A0, C0 - A0).GetSafeNormal();
-		FVector n1 = UKismetMathLibrary::Cross_VectorVector(C1 - A1, B1 - A1).GetSafeNormal();
-
-		normals.Add(n0);
-		normals.Add(n0);
-		normals.Add(n0);
-		normals.Add(n1);
-		normals.Add(n1);
-		normals.Add(n1);
-	}
-	CreateMeshSection(1, vertices, indices, normals, UVs, color, tangents, CreateCollision);
-}
-
-void USplineSweepMeshComponent::UpdateSideQuads(USplineComponent* path,float Rate )
-{
-	//Parameters used to create procedural mesh 
-	TArray<FVector> vertices;
-	TArray<int> indices;
-	TArray<FVector> normals;
-	TArray<FVector2D> UVs;
-	TArray<FColor> color;
-	TArray<FProcMeshTangent> tangents;
+void USplineSweepMeshComponent::EndProgressiveBuild()
+{
+	ProgressiveBuild.Reset();
+	SetComponentTickInterval(SplineSweepMeshComponent::LODTickInterval);
+	SetComponentTickEnabled(LODs.Num() > 0);
+}
 
-	TArray<FVector> SidePoints;
-	TArray<FVector> PointNormals;
-	TArray<FVector2D> PointUVs;
+void USplineSweepMeshComponent::CreateMeshSections()
+{
+	SPLINESWEEP_SCOPE(CreateMeshSection);
+	ActiveChunkSegments = ChunkSegments;
+	//Collision of every section is cooked by the last one created
+	const bool bCollision = UsesRenderCollision();
+	CreateSideChunkSections(bCollision, !SweepSettings.bHaveCover);
+	if (SweepSettings.bHaveCover)
+	{
+		CreateMeshSection(1, MeshBuffers.CoverVertices, MeshBuffers.CoverIndices, MeshBuffers.CoverNormals, EmptyUVs, EmptyColors, MeshBuffers.CoverTangents, bCollision);
+	}
+}
 
-	//Use  SweepPoints and SweepPointNormals to sweep along path to create side points 
-	SweepPointsAlongSpline(path, SweepPoints, SweepPointNormals, NumSegments, Rate,SidePoints, PointNormals, PointUVs);
+void USplineSweepMeshComponent::SetMaterial(int32 ElementIndex, UMaterialInterface* Material)
+{
+	Super::SetMaterial(ElementIndex, Material);
+	//Every chunk of side surface uses material of section 0
+	if (ElementIndex == 0)
+	{
+		for (int Chunk = 1; Chunk < SideChunks.Num(); Chunk++)
+		{
+			Super::SetMaterial(GetChunkSection(Chunk), Material);
+		}
+	}
+}
 
+int USplineSweepMeshComponent::GetNumSideChunks() const
+{
+	const int NumSegments = FMath::Max(MeshBuffers.RingKeys.Num() - 1, 0);
+	return ActiveChunkSegments > 0 ? FMath::Max(FMath::DivideAndRoundUp(NumSegments, ActiveChunkSegments), 1) : 1;
+}
 
-	//Branch when created,if user use smoothed normal or not
-	if (bUseSmoothNormal)
+void USplineSweepMeshComponent::FillSideChunk(int Chunk, bool bIndices)
+{
+	const int RingSize = SweepProfile->Num();
+	const int NumSegments = FMath::Max(MeshBuffers.RingKeys.Num() - 1, 0);
+	const int FirstSegment = FMath::Min(Chunk * ActiveChunkSegments, NumSegments);
+	const int LastSegment = FMath::Min(FirstSegment + ActiveChunkSegments, NumSegments);
+	//Rings are shared by neighbour chunks if use smoothed normal,quads own their vertices otherwise
+	const int FirstVertex = SweepSettings.bSmoothNormal ? FirstSegment * RingSize : FirstSegment * RingSize * 4;
+	const int NumVertices = SweepSettings.bSmoothNormal ? (LastSegment - FirstSegment + 1) * RingSize : (LastSegment - FirstSegment) * RingSize * 4;
+
+	FSideChunk& Side = SideChunks[Chunk];
+	Side.Vertices.SetNumUninitialized(NumVertices, false);
+	Side.Normals.SetNumUninitialized(NumVertices, false);
+	Side.UVs.SetNumUninitialized(NumVertices, false);
+	FMemory::Memcpy(Side.Vertices.GetData(), &MeshBuffers.SideVertices[FirstVertex], NumVertices * sizeof(FVector));
+	FMemory::Memcpy(Side.Normals.GetData(), &MeshBuffers.SideNormals[FirstVertex], NumVertices * sizeof(FVector));
+	FMemory::Memcpy(Side.UVs.GetData(), &MeshBuffers.SideUVs[FirstVertex], NumVertices * sizeof(FVector2D));
+	if (MeshBuffers.SideTangents.Num() > 0)
 	{
-		vertices = SidePoints;
-		normals = PointNormals;
-		UVs = PointUVs;
+		Side.Tangents.SetNumUninitialized(NumVertices, false);
+		FMemory::Memcpy(Side.Tangents.GetData(), &MeshBuffers.SideTangents[FirstVertex], NumVertices * sizeof(FProcMeshTangent));
 	}
 	else
 	{
-		//Convert side points into quad
-		TArray<QuadPoints> SideQuad;
-		for (int i = 0; i < NumSegments; i++)
+		Side.Tangents.Reset();
+	}
+
+	if (bIndices)
+	{
+		const int FirstIndex = FirstSegment * RingSize * 6;
+		Side.Indices.SetNumUninitialized((LastSegment - FirstSegment) * RingSize * 6, false);
+		for (int i = 0; i < Side.Indices.Num(); i++)
 		{
-			for (int j = 0; j < SweepPoints.Num(); j++)
-			{
-				int p1 = i * SweepPoints.Num();
-				int p2 = (i + 1) * SweepPoints.Num();
-				int n = (j + 1) == SweepPoints.Num() ? 0 : (j + 1);
-				FVector2D UVc = (j + 1) == SweepPoints.Num() ? FVector2D(1, PointUVs[p1 + n].Y) : PointUVs[p1 + n];
-				FVector2D UVd = (j + 1) == SweepPoints.Num() ? FVector2D(1, PointUVs[p2 + n].Y) : PointUVs[p2 + n];
+			Side.Indices[i] = MeshBuffers.SideIndices[FirstIndex + i] - FirstVertex;
+		}
+	}
+}
 
-				QuadPoints quad = QuadPoints(SidePoints[p1 + j], SidePoints[p2 + j], SidePoints[p1 + n], SidePoints[p2 + n],
-					PointUVs[p1 + j], PointUVs[p2 + j], UVc, UVd);
-				SideQuad.Add(quad);
+void USplineSweepMeshComponent::CreateSideChunkSections(bool bCollision, bool bCookCollision)
+{
+	if (ActiveChunkSegments <= 0)
+	{
+		for (int Chunk = 1; Chunk < SideChunks.Num(); Chunk++)
+		{
+			ClearMeshSection(GetChunkSection(Chunk));
+		}
+		SideChunks.Empty();
+		CreateMeshSection(0, MeshBuffers.SideVertices, MeshBuffers.SideIndices, MeshBuffers.SideNormals, MeshBuffers.SideUVs, EmptyColors, MeshBuffers.SideTangents, bCollision && bCookCollision);
+		EnableSectionCollision(0, bCollision);
+		return;
+	}
 
-			}
+	const int NumChunks = GetNumSideChunks();
+	//Clear sections of chunks an older mesh had beyond the new end
+	for (int Chunk = NumChunks; Chunk < SideChunks.Num(); Chunk++)
+	{
+		ClearMeshSection(GetChunkSection(Chunk));
+	}
+	SideChunks.SetNum(NumChunks);
+	for (int Chunk = 0; Chunk < NumChunks; Chunk++)
+	{
+		CreateSideChunkSection(Chunk, bCollision, bCookCollision && Chunk == NumChunks - 1);
+	}
+}
+
+void USplineSweepMeshComponent::CreateSideChunkSection(int Chunk, bool bCollision, bool bCookCollision)
+{
+	FillSideChunk(Chunk, true);
+	const FSideChunk& Side = SideChunks[Chunk];
+	CreateMeshSection(GetChunkSection(Chunk), Side.Vertices, Side.Indices, Side.Normals, Side.UVs, EmptyColors, Side.Tangents, bCollision && bCookCollision);
+	EnableSectionCollision(GetChunkSection(Chunk), bCollision);
+	//Chunks use material of side surface
+	if (Chunk > 0)
+	{
+		SetMaterial(GetChunkSection(Chunk), GetMaterial(0));
+	}
+}
+
+bool USplineSweepMeshComponent::UpdateSideChunkSections()
+{
+	if (ActiveChunkSegments <= 0)
+	{
+		FProcMeshSection* SideSection = GetProcMeshSection(0);
+		if (!SideSection || SideSection->ProcVertexBuffer.Num() != MeshBuffers.SideVertices.Num())
+		{
+			return false;
+		}
+		SPLINESWEEP_SCOPE(UpdateMeshSection);
+		UpdateSectionVertices(0, MeshBuffers.SideVertices, MeshBuffers.SideNormals, MeshBuffers.SideUVs, MeshBuffers.SideTangents);
+		return true;
+	}
+
+	const int RingSize = SweepProfile->Num();
+	const int NumSegments = FMath::Max(MeshBuffers.RingKeys.Num() - 1, 0);
+	const int ExpectedVertices = SweepSettings.bSmoothNormal ? (NumSegments + 1) * RingSize : NumSegments * RingSize * 4;
+	if (GetNumSideChunks() != SideChunks.Num() || MeshBuffers.SideVertices.Num() != ExpectedVertices)
+	{
+		return false;
+	}
+	//A chunk ends with the first ring of the next one
+	const int LastRing = DirtyLastRing == INDEX_NONE ? NumSegments : DirtyLastRing;
+	for (int Chunk = 0; Chunk < SideChunks.Num(); Chunk++)
+	{
+		const int FirstChunkRing = Chunk * ActiveChunkSegments;
+		if (FirstChunkRing > LastRing || FirstChunkRing + ActiveChunkSegments < DirtyFirstRing)
+		{
+			continue;
 		}
-		for (int i = 0; i < SideQuad.Num(); i++)
+		const int NumVertices = SideChunks[Chunk].Vertices.Num();
+		FillSideChunk(Chunk, false);
+		if (SideChunks[Chunk].Vertices.Num() != NumVertices)
 		{
-			QuadPoints quad = SideQuad[i];
-
-			vertices.Add(quad.pointA);
-			vertices.Add(quad.pointB);
-			vertices.Add(quad.pointC);
-			vertices.Add(quad.pointD);
-
-			UVs.Add(quad.UVa);
-			UVs.Add(quad.UVb);
-			UVs.Add(quad.UVc);
-			UVs.Add(quad.UVd);
-
-			//Calculate normal of triangles
-			FVector n1 = UKismetMathLibrary::Cross_VectorVector(quad.pointB - quad.pointA, quad.pointC - quad.pointA).GetSafeNormal();
-			FVector n2 = UKismetMathLibrary::Cross_VectorVector(quad.pointB - quad.pointC, quad.pointD - quad.pointC).GetSafeNormal();
-			FVector n3 = (n1 + n2) / 2;
-
-			normals.Add(n1);
-			normals.Add(n3);
-			normals.Add(n3);
-			normals.Add(n2);
+			return false;
 		}
+		SPLINESWEEP_SCOPE(UpdateMeshSection);
+		const FSideChunk& Side = SideChunks[Chunk];
+		UpdateSectionVertices(GetChunkSection(Chunk), Side.Vertices, Side.Normals, Side.UVs, Side.Tangents);
 	}
-	UpdateMeshSection(0, vertices, normals, UVs, color, tangents);
+	return true;
 }
 
-void USplineSweepMeshComponent::UpdateCoverTriangles(USplineComponent* path,float Rate )
+void USplineSweepMeshComponent::EnableSectionCollision(int Section, bool bCollision)
 {
-	//Parameters used to create procedural mesh 
-	TArray<FVector> vertices;
-	TArray<int> indices;
-	TArray<FVector> normals;
-	TArray<FVector2D> UVs;
-	TArray<FColor> color;
-	TArray<FProcMeshTangent> tangents;
+	//Cooked when the next section is created
+	if (FProcMeshSection* MeshSection = GetProcMeshSection(Section))
+	{
+		MeshSection->bEnableCollision = bCollision;
+	}
+}
 
-	for (int i = 0; i < CoverTriangles.Num(); i++)
+void USplineSweepMeshComponent::ApplyCollisionMode()
+{
+	ActiveCollisionMode = CollisionMode;
+	//Full detail collision of render mesh at coarser levels keeps flags of the user
+	if (SweepSettings.bCreateCollision && ActiveCollisionMode != ESplineSweepCollisionMode::RenderMesh)
 	{
-		//Transform matrix at start and end of path
-		FMatrix M0 = GetMatrixInSplineDistance(path, 0);
-		FMatrix M1 = GetMatrixInSplineDistance(path, path->GetSplineLength()*Rate);
+		//Flags of the user are kept,they are set again once no proxy is used
+		if (!bCollisionFlagsOverridden)
+		{
+			bUserUseAsyncCooking = bUseAsyncCooking;
+			bUserUseComplexAsSimpleCollision = bUseComplexAsSimpleCollision;
+			bCollisionFlagsOverridden = true;
+		}
+		//Proxy is cooked off game thread,convex chain is simple collision
+		bUseAsyncCooking = true;
+		bUseComplexAsSimpleCollision = ActiveCollisionMode != ESplineSweepCollisionMode::ConvexChain;
+	}
+	else if (bCollisionFlagsOverridden)
+	{
+		bUseAsyncCooking = bUserUseAsyncCooking;
+		bUseComplexAsSimpleCollision = bUserUseComplexAsSimpleCollision;
+		bCollisionFlagsOverridden = false;
+	}
+}
 
-		//Transform location of points into start and end of path 
-		FVector A0 = UKismetMathLibrary::Matrix_TransformPosition(M0, CoverTriangles[i].pointA);
-		FVector B0 = UKismetMathLibrary::Matrix_TransformPosition(M0, CoverTriangles[i].pointB);
-		FVector C0 = UKismetMathLibrary::Matrix_TransformPosition(M0, CoverTriangles[i].pointC);
-		FVector A1 = UKismetMathLibrary::Matrix_TransformPosition(M1, CoverTriangles[i].pointA);
-		FVector B1 = UKismetMathLibrary::Matrix_TransformPosition(M1, CoverTriangles[i].pointB);
-		FVector C1 = UKismetMathLibrary::Matrix_TransformPosition(M1, CoverTriangles[i].pointC);
+void USplineSweepMeshComponent::CreateCollisionProxy(USplineComponent* Path, float Rate)
+{
+	//Drop proxy of an older mesh,sections were cleared already
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(CollisionUpdateTimer);
+	}
+	if (CollisionConvexes.Num() > 0)
+	{
+		CollisionConvexes.Reset();
+		ClearCollisionConvexMeshes();
+	}
+	CollisionProfile.Reset();
+	CollisionBuffers.SideIndices.Reset();
+	if (!UsesCollisionProxy() || !Path || !BaseProfile.IsValid())
+	{
+		return;
+	}
+
+	//Proxy is built from full detail,so it does not change with LOD
+	CollisionSettings = BaseSettings;
+	if (ActiveCollisionMode == ESplineSweepCollisionMode::RenderMesh)
+	{
+		//Render mesh at a coarser level,collision keeps the full detail surface
+		CollisionProfile = BaseProfile;
+	}
+	else
+	{
+		CollisionProfile = FSplineSweepProfileCache::Get().FindOrCreateDecimated(*BaseProfile, CollisionProfilePoints, BaseSettings.bHaveCover);
+		CollisionSettings.NumSegments = CollisionSegments;
+		CollisionSettings.bAdaptiveSegments = false;
+		CollisionSettings.bParallel = false;
+	}
+	//Shared vertices,collision does not use normals
+	CollisionSettings.bSmoothNormal = true;
+	CollisionSettings.bGenerateTangents = false;
 
-		vertices.Add(A0);
-		vertices.Add(C0);
-		vertices.Add(B0);
-		vertices.Add(A1);
-		vertices.Add(B1);
-		vertices.Add(C1);
+	CollisionPath = Path;
+	CollisionRate = Rate;
+	UpdateCollisionProxy();
+}
 
-		//Calculate triangle's normal
-		FVector n0 = UKismetMathLibrary::Cross_VectorVector(B0 - A0, C0 - A0).GetSafeNormal();
-		FVector n1 = UKismetMathLibrary::Cross_VectorVector(C1 - A1, B1 - A1).GetSafeNormal();
+void USplineSweepMeshComponent::RequestCollisionUpdate(USplineComponent* Path, float Rate)
+{
+	if (!UsesCollisionProxy() || !CollisionProfile.IsValid())
+	{
+		return;
+	}
+	CollisionPath = Path;
+	CollisionRate = Rate;
 
-		normals.Add(n0);
-		normals.Add(n0);
-		normals.Add(n0);
-		normals.Add(n1);
-		normals.Add(n1);
-		normals.Add(n1);
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		UpdateCollisionProxy();
+		return;
+	}
+	FTimerManager& TimerManager = World->GetTimerManager();
+	const float Remaining = LastCollisionUpdateTime + CollisionUpdateInterval - World->GetRealTimeSeconds();
+	if (Remaining <= 0)
+	{
+		TimerManager.ClearTimer(CollisionUpdateTimer);
+		UpdateCollisionProxy();
+	}
+	else if (!TimerManager.IsTimerActive(CollisionUpdateTimer))
+	{
+		//Timer reads the latest requested state when it fires
+		TimerManager.SetTimer(CollisionUpdateTimer, this, &USplineSweepMeshComponent::UpdateCollisionProxy, Remaining, false);
 	}
-	UpdateMeshSection(1, vertices, normals, UVs, color, tangents);
 }
 
-void USplineSweepMeshComponent::SweepPointsAlongSpline(USplineComponent* path, TArray<FVector>& PointsToSweep, TArray<FVector>& NormalsToSweep, int SegmentsNumber, float Rate, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs)
+void USplineSweepMeshComponent::UpdateCollisionProxy()
 {
-	//Clear array
-	OutPoints.Empty();
-	OutNormal.Empty();
-	OutUVs.Empty();
+	SPLINESWEEP_SCOPE(CookCollision);
+	USplineComponent* Path = CollisionPath.Get();
+	if (!Path || !CollisionProfile.IsValid())
+	{
+		return;
+	}
+	UWorld* World = GetWorld();
+	LastCollisionUpdateTime = World ? World->GetRealTimeSeconds() : 0;
 
-	float SegmentLength = path->GetSplineLength()*Rate / SegmentsNumber;
-	for (int i = 0; i < SegmentsNumber; i++)
+	//Frames of render mesh are reused while path is unchanged,they are not replaced so incremental edits still see the built path
+	TSharedPtr<const FSplineSweepFrameCache, ESPMode::ThreadSafe> Frames = PathFrames;
+	if (!Frames.IsValid() || !Frames->IsUpToDate(Path, FrameCacheSamplesPerSegment, bRotationMinimizingFrames))
+	{
+		FSplineSweepPathSnapshot Snapshot;
+		Snapshot.Capture(Path);
+		TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+		NewFrames->Build(Snapshot, FrameCacheSamplesPerSegment, bRotationMinimizingFrames);
+		Frames = NewFrames;
+	}
+	FSplineSweepGenerator(*CollisionProfile, *Frames, CollisionSettings).Build(CollisionRate, CollisionBuffers, CollisionBuffers.SideIndices.Num() == 0);
+
+	if (ActiveCollisionMode == ESplineSweepCollisionMode::ConvexChain)
+	{
+		//One hull around every pair of neighbour rings
+		const int RingSize = CollisionProfile->Num();
+		const int NumSegments = RingSize > 0 ? CollisionBuffers.SideVertices.Num() / RingSize - 1 : 0;
+		CollisionConvexes.SetNum(FMath::Max(NumSegments, 0));
+		for (int i = 0; i < NumSegments; i++)
+		{
+			TArray<FVector>& Hull = CollisionConvexes[i];
+			Hull.SetNumUninitialized(RingSize * 2, false);
+			FMemory::Memcpy(Hull.GetData(), &CollisionBuffers.SideVertices[i * RingSize], RingSize * 2 * sizeof(FVector));
+		}
+		SetCollisionConvexMeshes(CollisionConvexes);
+	}
+	else
 	{
-		FMatrix M = GetMatrixInSplineDistance(path, i * SegmentLength);
-		for (int j = 0; j < PointsToSweep.Num(); j++)
+		//Covers share no vertices with side,append them after it
+		const int NumSideVertices = CollisionBuffers.SideVertices.Num();
+		CollisionVertices.Reset();
+		CollisionVertices.Append(CollisionBuffers.SideVertices);
+		CollisionIndices.Reset();
+		CollisionIndices.Append(CollisionBuffers.SideIndices);
+		if (CollisionSettings.bHaveCover)
 		{
-			//Transform position and normal
-			OutPoints.Add(UKismetMathLibrary::Matrix_TransformPosition(M, PointsToSweep[j]));
-			OutNormal.Add(UKismetMathLibrary::Matrix_TransformVector(M, NormalsToSweep[j]).GetSafeNormal());
-			//Int to float to make "j / PointsToSweep.Num()" a float
-			float fj = j;
-			//Calculate UV,remap position into [0,1]
-			OutUVs.Add(FVector2D(fj / PointsToSweep.Num(), i * SegmentLength / path->GetSplineLength()*Rate));
+			CollisionVertices.Append(CollisionBuffers.CoverVertices);
+			for (int Index : CollisionBuffers.CoverIndices)
+			{
+				CollisionIndices.Add(NumSideVertices + Index);
+			}
 		}
+		//Created again so collision is cooked,asynchronously in game worlds
+		CreateMeshSection(2, CollisionVertices, CollisionIndices, EmptyNormals, EmptyUVs, EmptyColors, EmptyTangents, true);
+		SetMeshSectionVisible(2, false);
 	}
+}
 
-	//Add points at the end of path
-	FMatrix M = GetMatrixInSplineDistance(path, path->GetSplineLength()*Rate);
-	for (int j = 0; j < PointsToSweep.Num(); j++)
+void USplineSweepMeshComponent::UpdateMeshSections()
+{
+	//Number of rings changes with rate if use fixed spacing growth,or with path if use adaptive segments.UpdateMeshSection can not change topology
+	if (!UpdateSideChunkSections())
+	{
+		SPLINESWEEP_SCOPE(CreateMeshSection);
+		CreateSideChunkSections(UsesRenderCollision(), true);
+	}
+	if (SweepSettings.bHaveCover)
+	{
+		SPLINESWEEP_SCOPE(UpdateMeshSection);
+		UpdateSectionVertices(1, MeshBuffers.CoverVertices, MeshBuffers.CoverNormals, EmptyUVs, MeshBuffers.CoverTangents);
+	}
+	if (UsesRenderCollision())
 	{
-		FVector point = UKismetMathLibrary::Matrix_TransformPosition(M, PointsToSweep[j]);
-		OutPoints.Add(point);
-		float fj = j;
-		//At the end of path,UV should be(u,1)
-		OutUVs.Add(FVector2D(fj / PointsToSweep.Num(), 1));
-		OutNormal.Add(UKismetMathLibrary::Matrix_TransformVector(M, NormalsToSweep[j]).GetSafeNormal());
+		UpdateRenderCollisionVertices();
 	}
 }
 
-TrianglePoints USplineSweepMeshComponent::FindAndRemoveFirstTriangleInSplineArea(TArray<FVector>& points)
+void USplineSweepMeshComponent::UpdateSectionVertices(int Section, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<FVector2D>& UVs, const TArray<FProcMeshTangent>& Tangents)
 {
-	for (int i = 0; i < points.Num(); i++)
+	//Procedural mesh moves collision vertices of every section whenever one section with collision is updated,it is done once by UpdateRenderCollisionVertices instead
+	FProcMeshSection* MeshSection = GetProcMeshSection(Section);
+	const bool bCollision = MeshSection && MeshSection->bEnableCollision;
+	if (bCollision)
 	{
-		int a = i;
-		int b = (i + 1) == points.Num() ? 0 : i + 1;
-		int c = (i - 1) < 0 ? points.Num() - 1 : i - 1;
+		MeshSection->bEnableCollision = false;
+	}
+	UpdateMeshSection(Section, Vertices, Normals, UVs, EmptyColors, Tangents);
+	if (bCollision)
+	{
+		MeshSection->bEnableCollision = true;
+	}
+}
 
-		bool isTriangle=false;
-		//Use cross to make sure if triangle(a,b,c) is in the right side of spline
-		if (UKismetMathLibrary::Cross_VectorVector((points[b] - points[a]), (points[c] - points[a])).X < 0)
+void USplineSweepMeshComponent::UpdateRenderCollisionVertices()
+{
+	SPLINESWEEP_SCOPE(CookCollision);
+	//Same order as sections are cooked in,without cooking again
+	RenderCollisionVertices.Reset();
+	for (int Section = 0; Section < GetNumSections(); Section++)
+	{
+		const FProcMeshSection* MeshSection = GetProcMeshSection(Section);
+		if (MeshSection && MeshSection->bEnableCollision)
 		{
-			isTriangle = true;
-			//Check if other points in range of this triangle
-			for (int j = 0; j < points.Num(); j++)
+			for (const FProcMeshVertex& Vertex : MeshSection->ProcVertexBuffer)
 			{
-				if (j != a && j != b && j != c)
-				{
-					bool b1 = UKismetMathLibrary::Cross_VectorVector((points[b] - points[a]), (points[j] - points[a])).X < 0;
-					bool b2 = UKismetMathLibrary::Cross_VectorVector((points[a] - points[c]), (points[j] - points[c])).X < 0;
-					bool b3 = UKismetMathLibrary::Cross_VectorVector((points[c] - points[b]), (points[j] - points[b])).X < 0;
-					//if points[j] in range of triangle,this triangle should not be created 
-					if (b1 && b2 && b3)
-					{
-						isTriangle = false;
-						break;
-					}
-				}
-			}
-			if (isTriangle)
-			{
-				TrianglePoints retPoints = TrianglePoints(points[a], points[b], points[c]);
-				//Remove a point and create new triangles with left point later
-				points.RemoveAt(a);
-				return retPoints;
+				RenderCollisionVertices.Add(Vertex.Position);
 			}
 		}
 	}
-	//Preventing from infinity loop if none triangles can be created
-	points.Empty();
-	return TrianglePoints(FVector(), FVector(), FVector());
+	BodyInstance.UpdateTriMeshVertices(RenderCollisionVertices);
 }
 
-TArray<TrianglePoints> USplineSweepMeshComponent::ConvertSplineIntoTriangle(TArray<FVector>& points)
+void USplineSweepMeshComponent::UpdatePathFrames(USplineComponent* Path)
 {
-	TArray<TrianglePoints> triangles;
-	//If <3,can not create triangle
-	if (points.Num() < 3)
+	if (!PathFrames.IsValid() || !PathFrames->IsUpToDate(Path, FrameCacheSamplesPerSegment, bRotationMinimizingFrames))
 	{
-		points.Empty();
+		//Built into a new table,asynchronous builds may still read the old one
+		FSplineSweepPathSnapshot Snapshot;
+		Snapshot.Capture(Path);
+		TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+		NewFrames->Build(Snapshot, FrameCacheSamplesPerSegment, bRotationMinimizingFrames);
+		PathFrames = NewFrames;
+		BuiltPathSnapshot = MoveTemp(Snapshot);
 	}
-	//If =3,don not need to chek and itais a triangle
-	else if (points.Num() == 3)
+}
+
+void USplineSweepMeshComponent::ApplyLOD(int LOD)
+{
+	ActiveLOD = LODs.IsValidIndex(LOD - 1) ? LOD : 0;
+	SweepSettings = BaseSettings;
+	SweepProfile = BaseProfile;
+	if (ActiveLOD == 0 || !BaseProfile.IsValid())
 	{
-		if (UKismetMathLibrary::Cross_VectorVector((points[0] - points[1]), (points[2] - points[1])).X > 0)
-		triangles.Add(TrianglePoints(points[0], points[1], points[2]));
-		points.Empty();
+		return;
 	}
-	else
+
+	const FSplineSweepLOD& Level = LODs[ActiveLOD - 1];
+	const float SegmentFraction = FMath::Clamp(Level.SegmentFraction, 0.01f, 1.0f);
+	const float ProfileFraction = FMath::Clamp(Level.ProfileFraction, 0.01f, 1.0f);
+	SweepSettings.NumSegments = FMath::Max(FMath::RoundToInt(BaseSettings.NumSegments * SegmentFraction), 1);
+	SweepSettings.MaxChordDeviation = BaseSettings.MaxChordDeviation / SegmentFraction;
+	SweepSettings.MaxSegmentAngle = FMath::Min(BaseSettings.MaxSegmentAngle / SegmentFraction, 180.0f);
+	SweepProfile = FSplineSweepProfileCache::Get().FindOrCreateDecimated(*BaseProfile, FMath::RoundToInt(BaseProfile->Num() * ProfileFraction), BaseSettings.bHaveCover);
+}
+
+int USplineSweepMeshComponent::ComputeDesiredLOD() const
+{
+	UWorld* World = GetWorld();
+	if (!World || World->ViewLocationsRenderedLastFrame.Num() == 0)
+	{
+		return ActiveLOD;
+	}
+
+	float MinDistanceSquared = MAX_flt;
+	for (const FVector& ViewLocation : World->ViewLocationsRenderedLastFrame)
+	{
+		MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Bounds.Origin, ViewLocation));
+	}
+	const float Distance = FMath::Sqrt(MinDistanceSquared);
+	//Diameter of bounds over width of screen at that distance,with a 90 degree field of view
+	const float ScreenSize = Bounds.SphereRadius / FMath::Max(Distance, 1.0f);
+
+	//Thresholds the view is past already move back by the band,so a view at a threshold does not switch every tick
+	const float Band = FMath::Clamp(LODHysteresis, 0.0f, 0.9f);
+	int LOD = 0;
+	for (int i = 0; i < LODs.Num(); i++)
 	{
-		//Find first triangle and remove(in function"FindAndRemoveFirstTriangleInSplineArea"),and find next triangle recursion.Until no triangles can be created
-		TrianglePoints triangle = FindAndRemoveFirstTriangleInSplineArea(points);
-		triangles.Add(triangle);
-		if (points.Num() >= 3)
+		const float Side = ActiveLOD > i ? 1 : -1;
+		const bool bPastThreshold = LODMetric == ESplineSweepLODMetric::ScreenSize
+			? ScreenSize < LODs[i].Threshold * (1 + Side * Band)
+			: Distance > LODs[i].Threshold * (1 - Side * Band);
+		if (bPastThreshold)
 		{
-			TArray<TrianglePoints> temTriangles = ConvertSplineIntoTriangle(points);
-			triangles.Append(temTriangles);
+			LOD = i + 1;
 		}
 	}
-	return triangles;
+	return LOD;
+}
+
+void USplineSweepMeshComponent::SwitchLOD(int LOD)
+{
+	USplineComponent* Path = SweepPath.Get();
+	if (!Path)
+	{
+		return;
+	}
+	//Only the active level is generated,other levels are not kept
+	const bool bHadCollisionProxy = UsesCollisionProxy();
+	ApplyLOD(LOD);
+	ApplyPerformanceSettings(SweepSettings);
+	UpdatePathFrames(Path);
+	FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).Build(LastRate, MeshBuffers, true);
+	//Render collision moves into a full detail proxy at coarser levels and back at full detail,so physics does not change with the view
+	if (bHadCollisionProxy && !UsesCollisionProxy())
+	{
+		ClearMeshSection(2);
+	}
+	CreateMeshSections();
+	if (bHadCollisionProxy != UsesCollisionProxy())
+	{
+		CreateCollisionProxy(Path, LastRate);
+	}
+	SectionsInputHash = 0;
+}
+
+void USplineSweepMeshComponent::ApplySegmentationSettings(FSplineSweepSettings& Settings) const
+{
+	Settings.bFixedSpacingGrowth = GrowthMode == ESplineSweepGrowthMode::FixedSpacing;
+	Settings.bAdaptiveSegments = SegmentMode == ESplineSweepSegmentMode::ErrorTolerance && !Settings.bFixedSpacingGrowth;
+	Settings.MaxChordDeviation = MaxChordDeviation;
+	Settings.MaxSegmentAngle = MaxSegmentAngle;
+	Settings.MinSegments = MinAdaptiveSegments;
+	Settings.MaxSegments = MaxAdaptiveSegments;
+}
+
+void USplineSweepMeshComponent::ApplyPerformanceSettings(FSplineSweepSettings& Settings) const
+{
+	Settings.bVectorized = bVectorizedSweep;
+	Settings.bParallel = bParallelSweep;
+	Settings.ParallelVertexThreshold = ParallelVertexThreshold;
+	Settings.bGenerateTangents = bGenerateTangents;
+	Settings.bFlipTangentY = bFlipTangentY;
 }
 
 TArray<FVector> USplineSweepMeshComponent::GetSplinePointsLocation(USplineComponent* spline)
 {
+	SPLINESWEEP_SCOPE(ReadSplines);
 	int number = spline->GetNumberOfSplinePoints();
 	TArray<FVector> points;
 	for (int i = 0; i < number; i++)
@@ -461,6 +1291,7 @@ TArray<FVector> USplineSweepMeshComponent::GetSplinePointsLocation(USplineCompon
 
 TArray<FVector> USplineSweepMeshComponent::GetSplinePointsNormal(USplineComponent* spline)
 {
+	SPLINESWEEP_SCOPE(ReadSplines);
 	int number = spline->GetNumberOfSplinePoints();
 	TArray<FVector> normals;
 	for (int i = 0; i < number; i++)
@@ -471,35 +1302,71 @@ TArray<FVector> USplineSweepMeshComponent::GetSplinePointsNormal(USplineComponen
 	return normals;
 }
 
-FMatrix USplineSweepMeshComponent::GetMatrixInSplineDistance(USplineComponent* spline, float distance) const
+namespace SplineSweepMeshComponent
 {
-	FVector X;
-	FVector Z;
-	FVector scale;
+	//Each segment of profile is halved at most this many times
+	const int MaxProfileSubdivisions = 6;
 
-	//If distance is too long,use matrix in the end of path
-	if (distance > spline->GetSplineLength())
+	void AddProfilePoint(const USplineComponent* spline, float Key, TArray<FVector>& OutPoints, TArray<FVector>& OutNormals)
 	{
-		int n = spline->GetNumberOfSplinePoints() - 1;
-		X = spline->GetDirectionAtSplinePoint(n, ESplineCoordinateSpace::Local);
-		Z = spline->GetUpVectorAtSplinePoint(n, ESplineCoordinateSpace::Local);
-
-		scale = spline->GetScaleAtSplinePoint(n);
+		OutPoints.Add(spline->GetLocationAtSplineInputKey(Key, ESplineCoordinateSpace::Local));
+		//Use direction to calculate normal of side surface
+		OutNormals.Add(UKismetMathLibrary::Cross_VectorVector(FVector(1, 0, 0), spline->GetDirectionAtSplineInputKey(Key, ESplineCoordinateSpace::Local)));
 	}
-	else
+
+	//Add points inside span between two keys,not including its ends
+	void SubdivideProfileSpan(const USplineComponent* spline, float KeyA, float KeyB, float MaxDeviation, int Depth, TArray<FVector>& OutPoints, TArray<FVector>& OutNormals)
 	{
-		X = spline->GetDirectionAtDistanceAlongSpline(distance, ESplineCoordinateSpace::Local);
-		Z = spline->GetUpVectorAtDistanceAlongSpline(distance, ESplineCoordinateSpace::Local);
+		const FVector A = spline->GetLocationAtSplineInputKey(KeyA, ESplineCoordinateSpace::Local);
+		const FVector B = spline->GetLocationAtSplineInputKey(KeyB, ESplineCoordinateSpace::Local);
+		//Quarter points too,an S shaped span passes through the middle of its chord
+		float Deviation = 0;
+		for (float Alpha : { 0.25f, 0.5f, 0.75f })
+		{
+			const FVector P = spline->GetLocationAtSplineInputKey(FMath::Lerp(KeyA, KeyB, Alpha), ESplineCoordinateSpace::Local);
+			Deviation = FMath::Max(Deviation, FMath::PointDistToSegment(P, A, B));
+		}
+		if (Deviation <= MaxDeviation || Depth >= MaxProfileSubdivisions)
+		{
+			return;
+		}
 
-		//Scale matrix
-		scale = spline->GetScaleAtDistanceAlongSpline(distance);
+		const float KeyM = (KeyA + KeyB) * 0.5f;
+		SubdivideProfileSpan(spline, KeyA, KeyM, MaxDeviation, Depth + 1, OutPoints, OutNormals);
+		AddProfilePoint(spline, KeyM, OutPoints, OutNormals);
+		SubdivideProfileSpan(spline, KeyM, KeyB, MaxDeviation, Depth + 1, OutPoints, OutNormals);
 	}
-	FVector Y = UKismetMathLibrary::Cross_VectorVector(Z, X);
-	Y *= scale.Y;
-	Z *= scale.Z;
-
-	FMatrix M = FMatrix(FPlane(X, 0), FPlane(Y, 0), FPlane(Z, 0), FPlane(spline->GetLocationAtDistanceAlongSpline(distance, ESplineCoordinateSpace::Local)));
+}
 
-	return M;
+void USplineSweepMeshComponent::TessellateSplinePoints(USplineComponent* spline, float MaxDeviation, TArray<FVector>& OutPoints, TArray<FVector>& OutNormals)
+{
+	using namespace SplineSweepMeshComponent;
+
+	SPLINESWEEP_SCOPE(ReadSplines);
+	OutPoints.Reset();
+	OutNormals.Reset();
+	const int number = spline->GetNumberOfSplinePoints();
+	//Ring is closed by side surface anyway,the closing segment is only curved if spline is a closed loop
+	const int segments = spline->IsClosedLoop() ? number : number - 1;
+	for (int i = 0; i < number; i++)
+	{
+		AddProfilePoint(spline, i, OutPoints, OutNormals);
+		if (i < segments && MaxDeviation > 0)
+		{
+			SubdivideProfileSpan(spline, i, i + 1, MaxDeviation, 0, OutPoints, OutNormals);
+		}
+	}
 }
 
+void USplineSweepMeshComponent::GetProfilePoints(USplineComponent* spline, TArray<FVector>& OutPoints, TArray<FVector>& OutNormals)
+{
+	if (TessellatedProfileSpline != spline || TessellatedProfileVersion != spline->SplineCurves.Version || TessellatedProfileDeviation != MaxProfileDeviation)
+	{
+		TessellateSplinePoints(spline, MaxProfileDeviation, TessellatedProfilePoints, TessellatedProfileNormals);
+		TessellatedProfileSpline = spline;
+		TessellatedProfileVersion = spline->SplineCurves.Version;
+		TessellatedProfileDeviation = MaxProfileDeviation;
+	}
+	OutPoints = TessellatedProfilePoints;
+	OutNormals = TessellatedProfileNormals;
+}
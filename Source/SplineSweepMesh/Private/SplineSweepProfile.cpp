@@ -0,0 +1,166 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepProfile.h"
+#include "SplineSweepTriangulator.h"
+#include "SplineSweepStats.h"
+#include "Kismet/KismetMathLibrary.h"
+
+void FSplineSweepProfile::SetPoints(const TArray<FVector>& Points, const TArray<FVector>& Normals)
+{
+	check(Points.Num() == Normals.Num());
+	NumPoints = Points.Num();
+	Radius = 0;
+	CoverTriangles.Reset();
+	//Pad to whole batches,padded lanes stay zero
+	const int PaddedNum = Align(NumPoints, 4);
+
+	TArray<float>* Streams[] = { &X, &Y, &Z, &NX, &NY, &NZ, &U };
+	for (TArray<float>* Stream : Streams)
+	{
+		Stream->SetNumZeroed(PaddedNum);
+	}
+	for (int i = 0; i < NumPoints; i++)
+	{
+		X[i] = Points[i].X;
+		Y[i] = Points[i].Y;
+		Z[i] = Points[i].Z;
+		NX[i] = Normals[i].X;
+		NY[i] = Normals[i].Y;
+		NZ[i] = Normals[i].Z;
+		//Int to float to make "i / NumPoints" a float
+		U[i] = float(i) / NumPoints;
+		Radius = FMath::Max(Radius, Points[i].Size());
+	}
+}
+
+bool FSplineSweepProfile::Equals(const TArray<FVector>& Points, const TArray<FVector>& Normals) const
+{
+	if (Points.Num() != NumPoints || Normals.Num() != NumPoints)
+	{
+		return false;
+	}
+	for (int i = 0; i < NumPoints; i++)
+	{
+		if (GetPoint(i) != Points[i] || GetNormal(i) != Normals[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FSplineSweepProfile::Reset()
+{
+	NumPoints = 0;
+	Radius = 0;
+	X.Reset();
+	Y.Reset();
+	Z.Reset();
+	NX.Reset();
+	NY.Reset();
+	NZ.Reset();
+	U.Reset();
+	CoverTriangles.Reset();
+	CoverWinding = 1;
+}
+
+void FSplineSweepProfile::GetPoints(TArray<FVector>& OutPoints) const
+{
+	OutPoints.SetNumUninitialized(NumPoints);
+	for (int i = 0; i < NumPoints; i++)
+	{
+		OutPoints[i] = GetPoint(i);
+	}
+}
+
+void FSplineSweepProfile::TriangulateCover()
+{
+	SPLINESWEEP_SCOPE(TriangulateCover);
+	TArray<FVector> Points;
+	GetPoints(Points);
+	FSplineSweepTriangulator::Triangulate(Points, CoverTriangles);
+
+	//Profile is planar,so one triangle with area tells the winding of all of them
+	CoverWinding = 1;
+	for (int i = 0; i + 2 < CoverTriangles.Num(); i += 3)
+	{
+		const FVector A = Points[CoverTriangles[i]];
+		const float Winding = FVector::CrossProduct(Points[CoverTriangles[i + 1]] - A, Points[CoverTriangles[i + 2]] - A).X;
+		if (FMath::Abs(Winding) > SMALL_NUMBER)
+		{
+			CoverWinding = FMath::Sign(Winding);
+			break;
+		}
+	}
+}
+
+void FSplineSweepProfile::TransformRing(const FMatrix& M, FVector* OutPoints, FVector* OutNormals) const
+{
+	//Splat matrix rows,a point is transformed as X*M[0]+Y*M[1]+Z*M[2]+M[3]
+	const VectorRegister M00 = VectorSetFloat1(M.M[0][0]);
+	const VectorRegister M01 = VectorSetFloat1(M.M[0][1]);
+	const VectorRegister M02 = VectorSetFloat1(M.M[0][2]);
+	const VectorRegister M10 = VectorSetFloat1(M.M[1][0]);
+	const VectorRegister M11 = VectorSetFloat1(M.M[1][1]);
+	const VectorRegister M12 = VectorSetFloat1(M.M[1][2]);
+	const VectorRegister M20 = VectorSetFloat1(M.M[2][0]);
+	const VectorRegister M21 = VectorSetFloat1(M.M[2][1]);
+	const VectorRegister M22 = VectorSetFloat1(M.M[2][2]);
+	const VectorRegister M30 = VectorSetFloat1(M.M[3][0]);
+	const VectorRegister M31 = VectorSetFloat1(M.M[3][1]);
+	const VectorRegister M32 = VectorSetFloat1(M.M[3][2]);
+	const VectorRegister SmallNumber = VectorSetFloat1(SMALL_NUMBER);
+
+	for (int i = 0; i < NumPoints; i += 4)
+	{
+		const VectorRegister PX = VectorLoad(&X[i]);
+		const VectorRegister PY = VectorLoad(&Y[i]);
+		const VectorRegister PZ = VectorLoad(&Z[i]);
+		const VectorRegister QX = VectorLoad(&NX[i]);
+		const VectorRegister QY = VectorLoad(&NY[i]);
+		const VectorRegister QZ = VectorLoad(&NZ[i]);
+
+		//Positions
+		const VectorRegister OX = VectorMultiplyAdd(PX, M00, VectorMultiplyAdd(PY, M10, VectorMultiplyAdd(PZ, M20, M30)));
+		const VectorRegister OY = VectorMultiplyAdd(PX, M01, VectorMultiplyAdd(PY, M11, VectorMultiplyAdd(PZ, M21, M31)));
+		const VectorRegister OZ = VectorMultiplyAdd(PX, M02, VectorMultiplyAdd(PY, M12, VectorMultiplyAdd(PZ, M22, M32)));
+
+		//Normals,no translation
+		VectorRegister ONX = VectorMultiplyAdd(QX, M00, VectorMultiplyAdd(QY, M10, VectorMultiply(QZ, M20)));
+		VectorRegister ONY = VectorMultiplyAdd(QX, M01, VectorMultiplyAdd(QY, M11, VectorMultiply(QZ, M21)));
+		VectorRegister ONZ = VectorMultiplyAdd(QX, M02, VectorMultiplyAdd(QY, M12, VectorMultiply(QZ, M22)));
+
+		//Renormalize,same threshold as FVector::GetSafeNormal
+		const VectorRegister LengthSquared = VectorMultiplyAdd(ONX, ONX, VectorMultiplyAdd(ONY, ONY, VectorMultiply(ONZ, ONZ)));
+		const VectorRegister InvLength = VectorReciprocalSqrtAccurate(VectorMax(LengthSquared, SmallNumber));
+		const VectorRegister IsValid = VectorCompareGT(LengthSquared, SmallNumber);
+		ONX = VectorSelect(IsValid, VectorMultiply(ONX, InvLength), VectorZero());
+		ONY = VectorSelect(IsValid, VectorMultiply(ONY, InvLength), VectorZero());
+		ONZ = VectorSelect(IsValid, VectorMultiply(ONZ, InvLength), VectorZero());
+
+		//Back to array of structures
+		MS_ALIGN(16) float Lanes[6][4] GCC_ALIGN(16);
+		VectorStoreAligned(OX, Lanes[0]);
+		VectorStoreAligned(OY, Lanes[1]);
+		VectorStoreAligned(OZ, Lanes[2]);
+		VectorStoreAligned(ONX, Lanes[3]);
+		VectorStoreAligned(ONY, Lanes[4]);
+		VectorStoreAligned(ONZ, Lanes[5]);
+
+		const int NumLanes = FMath::Min(4, NumPoints - i);
+		for (int Lane = 0; Lane < NumLanes; Lane++)
+		{
+			OutPoints[i + Lane] = FVector(Lanes[0][Lane], Lanes[1][Lane], Lanes[2][Lane]);
+			OutNormals[i + Lane] = FVector(Lanes[3][Lane], Lanes[4][Lane], Lanes[5][Lane]);
+		}
+	}
+}
+
+void FSplineSweepProfile::TransformRingScalar(const FMatrix& M, FVector* OutPoints, FVector* OutNormals) const
+{
+	for (int i = 0; i < NumPoints; i++)
+	{
+		OutPoints[i] = UKismetMathLibrary::Matrix_TransformPosition(M, GetPoint(i));
+		OutNormals[i] = UKismetMathLibrary::Matrix_TransformVector(M, GetNormal(i)).GetSafeNormal();
+	}
+}
@@ -0,0 +1,102 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepProfileCache.h"
+#include "Misc/ScopeLock.h"
+
+FSplineSweepProfileCache& FSplineSweepProfileCache::Get()
+{
+	static FSplineSweepProfileCache Cache;
+	return Cache;
+}
+
+TSharedRef<const FSplineSweepProfile, ESPMode::ThreadSafe> FSplineSweepProfileCache::FindOrCreate(const TArray<FVector>& Points, const TArray<FVector>& Normals, bool bWithCover)
+{
+	uint32 Hash = FCrc::MemCrc32(Points.GetData(), Points.Num() * sizeof(FVector));
+	Hash = FCrc::MemCrc32(Normals.GetData(), Normals.Num() * sizeof(FVector), Hash);
+	Hash = HashCombine(Hash, bWithCover ? 1 : 0);
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		if (TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> Found = FindLocked(Hash, Points, Normals, bWithCover))
+		{
+			return Found.ToSharedRef();
+		}
+	}
+
+	//Triangulate without holding the lock,other threads may look up different profiles meanwhile
+	TSharedRef<FSplineSweepProfile, ESPMode::ThreadSafe> NewProfile = MakeShared<FSplineSweepProfile, ESPMode::ThreadSafe>();
+	NewProfile->SetPoints(Points, Normals);
+	if (bWithCover)
+	{
+		NewProfile->TriangulateCover();
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	//Another thread may have built the same profile first,keep the interned one
+	if (TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> Found = FindLocked(Hash, Points, Normals, bWithCover))
+	{
+		return Found.ToSharedRef();
+	}
+	if (++InsertionsSincePrune >= 64)
+	{
+		InsertionsSincePrune = 0;
+		for (auto It = Profiles.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().Profile.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+	FEntry& Entry = Profiles.Add(Hash);
+	Entry.Profile = NewProfile;
+	Entry.bWithCover = bWithCover;
+	return NewProfile;
+}
+
+TSharedRef<const FSplineSweepProfile, ESPMode::ThreadSafe> FSplineSweepProfileCache::FindOrCreateDecimated(const FSplineSweepProfile& Profile, int MaxPoints, bool bWithCover)
+{
+	int Stride = FMath::Max(FMath::DivideAndRoundUp(Profile.Num(), FMath::Max(MaxPoints, 3)), 1);
+	//Rounding up may leave fewer than 3 points,half of a square would be a flat strip
+	while (Stride > 1 && FMath::DivideAndRoundUp(Profile.Num(), Stride) < 3)
+	{
+		Stride--;
+	}
+	TArray<FVector> Points;
+	TArray<FVector> Normals;
+	for (int i = 0; i < Profile.Num(); i += Stride)
+	{
+		Points.Add(Profile.GetPoint(i));
+		Normals.Add(Profile.GetNormal(i));
+	}
+	return FindOrCreate(Points, Normals, bWithCover);
+}
+
+int FSplineSweepProfileCache::GetNumProfiles() const
+{
+	FScopeLock ScopeLock(&Lock);
+	int NumProfiles = 0;
+	for (const TPair<uint32, FEntry>& Pair : Profiles)
+	{
+		NumProfiles += Pair.Value.Profile.IsValid() ? 1 : 0;
+	}
+	return NumProfiles;
+}
+
+TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> FSplineSweepProfileCache::FindLocked(uint32 Hash, const TArray<FVector>& Points, const TArray<FVector>& Normals, bool bWithCover) const
+{
+	for (auto It = Profiles.CreateConstKeyIterator(Hash); It; ++It)
+	{
+		const FEntry& Entry = It.Value();
+		if (Entry.bWithCover != bWithCover)
+		{
+			continue;
+		}
+		TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> Profile = Entry.Profile.Pin();
+		if (Profile.IsValid() && Profile->Equals(Points, Normals))
+		{
+			return Profile;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,423 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepRenderComponent.h"
+#include "SplineSweepMeshComponent.h"
+#include "SplineSweepProfileCache.h"
+#include "SplineSweepStats.h"
+#include "PrimitiveSceneProxy.h"
+#include "DynamicMeshBuilder.h"
+#include "LocalVertexFactory.h"
+#include "Rendering/ColorVertexBuffer.h"
+#include "StaticMeshResources.h"
+#include "Materials/Material.h"
+#include "Engine/Engine.h"
+#include "SceneManagement.h"
+
+//GPU only vertex stream,rewritten every update so it is dynamic and keeps no CPU copy
+class FSplineSweepVertexBuffer : public FVertexBuffer
+{
+public:
+	FShaderResourceViewRHIRef ShaderResourceView;
+	int NumVertices = 0;
+	uint32 Stride = 0;
+	//Element size and format seen by manual vertex fetch
+	uint32 SRVStride = 0;
+	EPixelFormat SRVFormat = PF_Unknown;
+
+	void Setup(int InNumVertices, uint32 InStride, uint32 InSRVStride, EPixelFormat InSRVFormat)
+	{
+		NumVertices = InNumVertices;
+		Stride = InStride;
+		SRVStride = InSRVStride;
+		SRVFormat = InSRVFormat;
+	}
+
+	virtual void InitRHI() override
+	{
+		FRHIResourceCreateInfo CreateInfo;
+		VertexBufferRHI = RHICreateVertexBuffer(NumVertices * Stride, BUF_Dynamic | BUF_ShaderResource, CreateInfo);
+		if (RHISupportsManualVertexFetch(GMaxRHIShaderPlatform))
+		{
+			ShaderResourceView = RHICreateShaderResourceView(VertexBufferRHI, SRVStride, SRVFormat);
+		}
+	}
+
+	virtual void ReleaseRHI() override
+	{
+		ShaderResourceView.SafeRelease();
+		FVertexBuffer::ReleaseRHI();
+	}
+
+	//Copy a packed stream into the locked buffer.Render thread
+	void Write(const void* Data)
+	{
+		void* VertexBufferData = RHILockVertexBuffer(VertexBufferRHI, 0, NumVertices * Stride, RLM_WriteOnly);
+		FMemory::Memcpy(VertexBufferData, Data, NumVertices * Stride);
+		RHIUnlockVertexBuffer(VertexBufferRHI);
+	}
+};
+
+//Buffers of one section on the render thread
+class FSplineSweepProxySection
+{
+public:
+	FSplineSweepProxySection(ERHIFeatureLevel::Type FeatureLevel)
+		: VertexFactory(FeatureLevel, "FSplineSweepProxySection")
+	{
+	}
+
+	UMaterialInterface* Material = nullptr;
+	FSplineSweepVertexBuffer PositionBuffer;
+	FSplineSweepVertexBuffer TangentBuffer;
+	FSplineSweepVertexBuffer TexCoordBuffer;
+	FDynamicMeshIndexBuffer32 IndexBuffer;
+	FLocalVertexFactory VertexFactory;
+	int NumVertices = 0;
+
+	//Create buffers sized for the section,vertices are written by Upload
+	void Init(const FSplineSweepRenderSection& Section)
+	{
+		NumVertices = Section.Positions.Num();
+		if (NumVertices == 0)
+		{
+			return;
+		}
+		//Layout of the packed data,float positions,8 bit tangents and 16 bit UVs
+		PositionBuffer.Setup(NumVertices, sizeof(FVector), sizeof(float), PF_R32_FLOAT);
+		TangentBuffer.Setup(NumVertices, 2 * sizeof(FPackedNormal), sizeof(FPackedNormal), PF_R8G8B8A8_SNORM);
+		TexCoordBuffer.Setup(NumVertices, sizeof(FVector2DHalf), sizeof(FVector2DHalf), PF_G16R16F);
+		BeginInitResource(&PositionBuffer);
+		BeginInitResource(&TangentBuffer);
+		BeginInitResource(&TexCoordBuffer);
+		IndexBuffer.Indices = Section.Indices;
+		BeginInitResource(&IndexBuffer);
+
+		FSplineSweepProxySection* Self = this;
+		ENQUEUE_RENDER_COMMAND(SplineSweepInitVertexFactory)(
+			[Self](FRHICommandListImmediate& RHICmdList)
+			{
+				Self->InitVertexFactory_RenderThread();
+			});
+	}
+
+	void Release()
+	{
+		if (NumVertices > 0)
+		{
+			PositionBuffer.ReleaseResource();
+			TangentBuffer.ReleaseResource();
+			TexCoordBuffer.ReleaseResource();
+			IndexBuffer.ReleaseResource();
+			VertexFactory.ReleaseResource();
+		}
+	}
+
+	//Write packed vertices straight into the locked GPU buffers.Render thread
+	void Upload(const FSplineSweepRenderSection& Section)
+	{
+		check(IsInRenderingThread());
+		if (NumVertices == 0 || Section.Positions.Num() != NumVertices)
+		{
+			return;
+		}
+		PositionBuffer.Write(Section.Positions.GetData());
+		TangentBuffer.Write(Section.Tangents.GetData());
+		TexCoordBuffer.Write(Section.UVs.GetData());
+	}
+
+private:
+	void InitVertexFactory_RenderThread()
+	{
+		const uint32 TangentStride = 2 * sizeof(FPackedNormal);
+		FLocalVertexFactory::FDataType Data;
+		Data.PositionComponent = FVertexStreamComponent(&PositionBuffer, 0, sizeof(FVector), VET_Float3);
+		Data.PositionComponentSRV = PositionBuffer.ShaderResourceView;
+		Data.TangentBasisComponents[0] = FVertexStreamComponent(&TangentBuffer, 0, TangentStride, VET_PackedNormal);
+		Data.TangentBasisComponents[1] = FVertexStreamComponent(&TangentBuffer, sizeof(FPackedNormal), TangentStride, VET_PackedNormal);
+		Data.TangentsSRV = TangentBuffer.ShaderResourceView;
+		Data.TextureCoordinates.Add(FVertexStreamComponent(&TexCoordBuffer, 0, sizeof(FVector2DHalf), VET_Half2));
+		Data.TextureCoordinatesSRV = TexCoordBuffer.ShaderResourceView;
+		Data.NumTexCoords = 1;
+		Data.LightMapCoordinateIndex = 0;
+		//No color stream,the vertex factory reads white from the global null color buffer
+		Data.ColorComponentsSRV = GNullColorVertexBuffer.VertexBufferSRV;
+		Data.ColorIndexMask = 0;
+		VertexFactory.SetData(Data);
+		VertexFactory.InitResource();
+	}
+};
+
+class FSplineSweepSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+	FSplineSweepSceneProxy(USplineSweepRenderComponent* Component, TUniquePtr<FSplineSweepRenderData> Data)
+		: FPrimitiveSceneProxy(Component)
+		, MaterialRelevance(Component->GetMaterialRelevance(GetScene().GetFeatureLevel()))
+	{
+		for (int SectionIndex = 0; SectionIndex < 2; SectionIndex++)
+		{
+			FSplineSweepProxySection* Section = new FSplineSweepProxySection(GetScene().GetFeatureLevel());
+			Section->Material = Component->GetMaterial(SectionIndex);
+			if (!Section->Material)
+			{
+				Section->Material = UMaterial::GetDefaultMaterial(MD_Surface);
+			}
+			Section->Init(Data->Sections[SectionIndex]);
+			Sections.Add(Section);
+		}
+
+		//First upload goes through the same path as updates
+		FSplineSweepSceneProxy* Proxy = this;
+		FSplineSweepRenderData* RawData = Data.Release();
+		ENQUEUE_RENDER_COMMAND(SplineSweepInitProxy)(
+			[Proxy, RawData](FRHICommandListImmediate& RHICmdList)
+			{
+				Proxy->SetData_RenderThread(TUniquePtr<FSplineSweepRenderData>(RawData));
+			});
+	}
+
+	virtual ~FSplineSweepSceneProxy()
+	{
+		for (FSplineSweepProxySection* Section : Sections)
+		{
+			Section->Release();
+			delete Section;
+		}
+	}
+
+	//Write vertices of every section into its buffers,data is freed when done
+	void SetData_RenderThread(TUniquePtr<FSplineSweepRenderData> Data)
+	{
+		SPLINESWEEP_SCOPE(UpdateMeshSection);
+		for (int SectionIndex = 0; SectionIndex < Sections.Num(); SectionIndex++)
+		{
+			Sections[SectionIndex]->Upload(Data->Sections[SectionIndex]);
+		}
+	}
+
+	virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views, const FSceneViewFamily& ViewFamily, uint32 VisibilityMap, FMeshElementCollector& Collector) const override
+	{
+		const bool bWireframe = AllowDebugViewmodes() && ViewFamily.EngineShowFlags.Wireframe;
+		FColoredMaterialRenderProxy* WireframeMaterialInstance = nullptr;
+		if (bWireframe)
+		{
+			WireframeMaterialInstance = new FColoredMaterialRenderProxy(GEngine->WireframeMaterial ? GEngine->WireframeMaterial->GetRenderProxy() : nullptr, FLinearColor(0, 0.5f, 1.f));
+			Collector.RegisterOneFrameMaterialProxy(WireframeMaterialInstance);
+		}
+
+		for (const FSplineSweepProxySection* Section : Sections)
+		{
+			if (Section->NumVertices == 0 || Section->IndexBuffer.Indices.Num() == 0)
+			{
+				continue;
+			}
+			FMaterialRenderProxy* MaterialProxy = bWireframe ? WireframeMaterialInstance : Section->Material->GetRenderProxy();
+			for (int32 ViewIndex = 0; ViewIndex < Views.Num(); ViewIndex++)
+			{
+				if (!(VisibilityMap & (1 << ViewIndex)))
+				{
+					continue;
+				}
+				FMeshBatch& Mesh = Collector.AllocateMesh();
+				FMeshBatchElement& BatchElement = Mesh.Elements[0];
+				BatchElement.IndexBuffer = &Section->IndexBuffer;
+				Mesh.bWireframe = bWireframe;
+				Mesh.VertexFactory = &Section->VertexFactory;
+				Mesh.MaterialRenderProxy = MaterialProxy;
+
+				bool bHasPrecomputedVolumetricLightmap;
+				FMatrix PreviousLocalToWorld;
+				int32 SingleCaptureIndex;
+				bool bOutputVelocity;
+				GetScene().GetPrimitiveUniformShaderParameters_RenderThread(GetPrimitiveSceneInfo(), bHasPrecomputedVolumetricLightmap, PreviousLocalToWorld, SingleCaptureIndex, bOutputVelocity);
+
+				FDynamicPrimitiveUniformBuffer& DynamicPrimitiveUniformBuffer = Collector.AllocateOneFrameResource<FDynamicPrimitiveUniformBuffer>();
+				DynamicPrimitiveUniformBuffer.Set(GetLocalToWorld(), PreviousLocalToWorld, GetBounds(), GetLocalBounds(), true, bHasPrecomputedVolumetricLightmap, DrawsVelocity(), bOutputVelocity);
+				BatchElement.PrimitiveUniformBufferResource = &DynamicPrimitiveUniformBuffer.UniformBuffer;
+
+				BatchElement.FirstIndex = 0;
+				BatchElement.NumPrimitives = Section->IndexBuffer.Indices.Num() / 3;
+				BatchElement.MinVertexIndex = 0;
+				BatchElement.MaxVertexIndex = Section->NumVertices - 1;
+				Mesh.ReverseCulling = IsLocalToWorldDeterminantNegative();
+				Mesh.Type = PT_TriangleList;
+				Mesh.DepthPriorityGroup = SDPG_World;
+				Mesh.bCanApplyViewModeOverrides = false;
+				Collector.AddMesh(ViewIndex, Mesh);
+			}
+		}
+	}
+
+	virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+	{
+		FPrimitiveViewRelevance Result;
+		Result.bDrawRelevance = IsShown(View);
+		Result.bShadowRelevance = IsShadowCast(View);
+		Result.bDynamicRelevance = true;
+		Result.bRenderInMainPass = ShouldRenderInMainPass();
+		Result.bUsesLightingChannels = GetLightingChannelMask() != GetDefaultLightingChannelMask();
+		Result.bRenderCustomDepth = ShouldRenderCustomDepth();
+		Result.bTranslucentSelfShadow = bCastVolumetricTranslucentShadow;
+		MaterialRelevance.SetPrimitiveViewRelevance(Result);
+		Result.bVelocityRelevance = IsMovable() && Result.bOpaque && Result.bRenderInMainPass;
+		return Result;
+	}
+
+	virtual bool CanBeOccluded() const override { return !MaterialRelevance.bDisableDepthTest; }
+	virtual uint32 GetMemoryFootprint() const override { return sizeof(*this) + GetAllocatedSize(); }
+	virtual SIZE_T GetTypeHash() const override
+	{
+		static size_t UniquePointer;
+		return reinterpret_cast<size_t>(&UniquePointer);
+	}
+
+private:
+	TArray<FSplineSweepProxySection*> Sections;
+	FMaterialRelevance MaterialRelevance;
+};
+
+void USplineSweepRenderComponent::CreateSweepMesh(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal)
+{
+	SPLINESWEEP_SCOPE(CreateSweepMesh);
+	if (!SweepSpline || !PathSpline)
+	{
+		return;
+	}
+
+	SweepSettings.NumSegments = segments;
+	SweepSettings.bSmoothNormal = SmoothNormal;
+	//If is not closed loop,create covers
+	SweepSettings.bHaveCover = !PathSpline->IsClosedLoop();
+	//Packed vertices always carry tangents
+	SweepSettings.bGenerateTangents = true;
+
+	TArray<FVector> ProfilePoints;
+	TArray<FVector> ProfileNormals;
+	USplineSweepMeshComponent::TessellateSplinePoints(SweepSpline, MaxProfileDeviation, ProfilePoints, ProfileNormals);
+	SweepProfile = FSplineSweepProfileCache::Get().FindOrCreate(ProfilePoints, ProfileNormals, SweepSettings.bHaveCover);
+
+	FSplineSweepPathSnapshot Snapshot;
+	Snapshot.Capture(PathSpline);
+	TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+	NewFrames->Build(Snapshot, FrameCacheSamplesPerSegment);
+	PathFrames = NewFrames;
+
+	FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).Build(Rate, MeshBuffers, true);
+	bTopologyDirty = true;
+	SendRenderData();
+}
+
+void USplineSweepRenderComponent::UpdatePathSpline(USplineComponent* Path, float Rate)
+{
+	SPLINESWEEP_SCOPE(UpdatePathSpline);
+	if (!Path || !SweepProfile.IsValid())
+	{
+		return;
+	}
+
+	if (!PathFrames->IsUpToDate(Path, FrameCacheSamplesPerSegment))
+	{
+		FSplineSweepPathSnapshot Snapshot;
+		Snapshot.Capture(Path);
+		TSharedPtr<FSplineSweepFrameCache, ESPMode::ThreadSafe> NewFrames = MakeShared<FSplineSweepFrameCache, ESPMode::ThreadSafe>();
+		NewFrames->Build(Snapshot, FrameCacheSamplesPerSegment);
+		PathFrames = NewFrames;
+	}
+	const int NumSideVertices = MeshBuffers.SideVertices.Num();
+	const int NumSideIndices = MeshBuffers.SideIndices.Num();
+	FSplineSweepGenerator(*SweepProfile, *PathFrames, SweepSettings).Build(Rate, MeshBuffers, false);
+	//Fixed spacing growth and adaptive segments are not used here,but keep buffers consistent if counts ever change
+	bTopologyDirty |= NumSideVertices != MeshBuffers.SideVertices.Num() || NumSideIndices != MeshBuffers.SideIndices.Num();
+	SendRenderData();
+}
+
+TUniquePtr<FSplineSweepRenderData> USplineSweepRenderComponent::PackRenderData(bool bWithIndices) const
+{
+	SPLINESWEEP_SCOPE(UpdateMeshSection);
+	TUniquePtr<FSplineSweepRenderData> Data = MakeUnique<FSplineSweepRenderData>();
+	const TArray<FVector>* Vertices[] = { &MeshBuffers.SideVertices, &MeshBuffers.CoverVertices };
+	const TArray<FVector>* Normals[] = { &MeshBuffers.SideNormals, &MeshBuffers.CoverNormals };
+	const TArray<FProcMeshTangent>* Tangents[] = { &MeshBuffers.SideTangents, &MeshBuffers.CoverTangents };
+	const TArray<int>* Indices[] = { &MeshBuffers.SideIndices, &MeshBuffers.CoverIndices };
+	const int NumSections = SweepSettings.bHaveCover ? 2 : 1;
+
+	for (int SectionIndex = 0; SectionIndex < NumSections; SectionIndex++)
+	{
+		FSplineSweepRenderSection& Section = Data->Sections[SectionIndex];
+		const int NumVertices = Vertices[SectionIndex]->Num();
+		Section.Positions = *Vertices[SectionIndex];
+		Section.Tangents.SetNumUninitialized(NumVertices * 2);
+		Section.UVs.SetNumUninitialized(NumVertices);
+		for (int i = 0; i < NumVertices; i++)
+		{
+			const FProcMeshTangent Tangent = Tangents[SectionIndex]->IsValidIndex(i) ? (*Tangents[SectionIndex])[i] : FProcMeshTangent();
+			Section.Tangents[i * 2] = FPackedNormal(Tangent.TangentX);
+			Section.Tangents[i * 2 + 1] = FPackedNormal(FVector4((*Normals[SectionIndex])[i], Tangent.bFlipTangentY ? -1 : 1));
+			//Covers have no UVs
+			Section.UVs[i] = SectionIndex == 0 ? FVector2DHalf(MeshBuffers.SideUVs[i]) : FVector2DHalf(FVector2D::ZeroVector);
+		}
+		if (bWithIndices)
+		{
+			Section.Indices.SetNumUninitialized(Indices[SectionIndex]->Num());
+			for (int i = 0; i < Section.Indices.Num(); i++)
+			{
+				Section.Indices[i] = (*Indices[SectionIndex])[i];
+			}
+		}
+	}
+	return Data;
+}
+
+void USplineSweepRenderComponent::SendRenderData()
+{
+	const FBox PreviousBox = LocalBox;
+	LocalBox = FBox(MeshBuffers.SideVertices);
+	if (SweepSettings.bHaveCover)
+	{
+		LocalBox += FBox(MeshBuffers.CoverVertices);
+	}
+	const bool bBoundsChanged = !(LocalBox == PreviousBox) || LocalBox.IsValid != PreviousBox.IsValid;
+	if (bBoundsChanged)
+	{
+		UpdateBounds();
+	}
+
+	//Buffers of the proxy are sized for its topology,a new proxy is created with the new one
+	if (bTopologyDirty || !SceneProxy)
+	{
+		bTopologyDirty = false;
+		MarkRenderStateDirty();
+		return;
+	}
+	//Proxy bounds only need a refresh when the mesh grew or shrank
+	if (bBoundsChanged)
+	{
+		MarkRenderTransformDirty();
+	}
+
+	FSplineSweepSceneProxy* Proxy = static_cast<FSplineSweepSceneProxy*>(SceneProxy);
+	FSplineSweepRenderData* RawData = PackRenderData(false).Release();
+	ENQUEUE_RENDER_COMMAND(SplineSweepUpdateProxy)(
+		[Proxy, RawData](FRHICommandListImmediate& RHICmdList)
+		{
+			Proxy->SetData_RenderThread(TUniquePtr<FSplineSweepRenderData>(RawData));
+		});
+}
+
+FPrimitiveSceneProxy* USplineSweepRenderComponent::CreateSceneProxy()
+{
+	if (!SweepProfile.IsValid() || MeshBuffers.SideVertices.Num() == 0)
+	{
+		return nullptr;
+	}
+	return new FSplineSweepSceneProxy(this, PackRenderData(true));
+}
+
+FBoxSphereBounds USplineSweepRenderComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBox.IsValid)
+	{
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0);
+	}
+	return FBoxSphereBounds(LocalBox).TransformBy(LocalToWorld);
+}
@@ -0,0 +1,46 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepStats.h"
+
+DEFINE_STAT(STAT_SplineSweep_CreateSweepMesh);
+DEFINE_STAT(STAT_SplineSweep_UpdatePathSpline);
+DEFINE_STAT(STAT_SplineSweep_AsyncBuild);
+DEFINE_STAT(STAT_SplineSweep_ProgressiveBuild);
+DEFINE_STAT(STAT_SplineSweep_ReadSplines);
+DEFINE_STAT(STAT_SplineSweep_EvaluateFrames);
+DEFINE_STAT(STAT_SplineSweep_SweepPoints);
+DEFINE_STAT(STAT_SplineSweep_ExpandQuads);
+DEFINE_STAT(STAT_SplineSweep_TriangulateCover);
+DEFINE_STAT(STAT_SplineSweep_BuildCovers);
+DEFINE_STAT(STAT_SplineSweep_CreateMeshSection);
+DEFINE_STAT(STAT_SplineSweep_UpdateMeshSection);
+DEFINE_STAT(STAT_SplineSweep_CookCollision);
+DEFINE_STAT(STAT_SplineSweep_ScheduledUpdates);
+DEFINE_STAT(STAT_SplineSweep_QueueDepth);
+DEFINE_STAT(STAT_SplineSweep_DeferredUpdates);
+DEFINE_STAT(STAT_SplineSweep_OverBudgetUpdates);
+DEFINE_STAT(STAT_SplineSweep_HashInputs);
+DEFINE_STAT(STAT_SplineSweep_SkippedBuilds);
+DEFINE_STAT(STAT_SplineSweep_BufferMemory);
+DEFINE_STAT(STAT_SplineSweep_FrameCacheMemory);
+
+CSV_DEFINE_CATEGORY_MODULE(SPLINESWEEPMESH_API, SplineSweep, true);
+
+void FSplineSweepMemoryCounter::Set(SIZE_T Size)
+{
+	if (Size == Reported)
+	{
+		return;
+	}
+	if (Stat == ESplineSweepMemoryStat::Buffers)
+	{
+		DEC_MEMORY_STAT_BY(STAT_SplineSweep_BufferMemory, Reported);
+		INC_MEMORY_STAT_BY(STAT_SplineSweep_BufferMemory, Size);
+	}
+	else
+	{
+		DEC_MEMORY_STAT_BY(STAT_SplineSweep_FrameCacheMemory, Reported);
+		INC_MEMORY_STAT_BY(STAT_SplineSweep_FrameCacheMemory, Size);
+	}
+	Reported = Size;
+}
@@ -0,0 +1,146 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepTriangulator.h"
+
+namespace SplineSweepTriangulator
+{
+	//X of Cross(B - A, C - A),negative if A,B,C turn the way covers are wound
+	FORCEINLINE float CrossX(const FVector& A, const FVector& B, const FVector& C)
+	{
+		return (B.Y - A.Y) * (C.Z - A.Z) - (B.Z - A.Z) * (C.Y - A.Y);
+	}
+
+	//Strictly inside triangle(A,B,C),points on edges do not block an ear
+	FORCEINLINE bool IsInsideTriangle(const FVector& A, const FVector& B, const FVector& C, const FVector& P)
+	{
+		return CrossX(A, B, P) < 0 && CrossX(C, A, P) < 0 && CrossX(B, C, P) < 0;
+	}
+}
+
+int FSplineSweepTriangulator::Triangulate(const TArray<FVector>& Points, TArray<int>& OutIndices)
+{
+	using namespace SplineSweepTriangulator;
+
+	OutIndices.Reset();
+	const int NumPoints = Points.Num();
+	//If <3,can not create triangle
+	if (NumPoints < 3)
+	{
+		return 0;
+	}
+	OutIndices.Reserve((NumPoints - 2) * 3);
+
+	//Ears are convex when the outline turns with negative CrossX,walk the outline backwards if it is wound the other way
+	float DoubleArea = 0;
+	for (int i = 0; i < NumPoints; i++)
+	{
+		const FVector& A = Points[i];
+		const FVector& B = Points[(i + 1) % NumPoints];
+		DoubleArea += A.Y * B.Z - B.Y * A.Z;
+	}
+	const bool bReversed = DoubleArea > 0;
+
+	//Linked list of remaining vertices
+	TArray<int> Next;
+	TArray<int> Prev;
+	Next.SetNumUninitialized(NumPoints);
+	Prev.SetNumUninitialized(NumPoints);
+	for (int i = 0; i < NumPoints; i++)
+	{
+		const int Forward = (i + 1) % NumPoints;
+		const int Backward = (i + NumPoints - 1) % NumPoints;
+		Next[i] = bReversed ? Backward : Forward;
+		Prev[i] = bReversed ? Forward : Backward;
+	}
+
+	//Only vertices which are not convex can lie inside an ear
+	TArray<bool> IsReflex;
+	TArray<int> ReflexVertices;
+	IsReflex.SetNumUninitialized(NumPoints);
+	auto UpdateReflex = [&](int Vertex)
+	{
+		const bool bReflex = !(CrossX(Points[Vertex], Points[Next[Vertex]], Points[Prev[Vertex]]) < 0);
+		if (bReflex && !IsReflex[Vertex])
+		{
+			ReflexVertices.Add(Vertex);
+		}
+		else if (!bReflex && IsReflex[Vertex])
+		{
+			ReflexVertices.RemoveSingleSwap(Vertex, false);
+		}
+		IsReflex[Vertex] = bReflex;
+	};
+	for (int i = 0; i < NumPoints; i++)
+	{
+		IsReflex[i] = false;
+		UpdateReflex(i);
+	}
+
+	auto IsEar = [&](int Vertex)
+	{
+		if (IsReflex[Vertex])
+		{
+			return false;
+		}
+		const int B = Next[Vertex];
+		const int C = Prev[Vertex];
+		for (int Reflex : ReflexVertices)
+		{
+			if (Reflex != B && Reflex != C && IsInsideTriangle(Points[Vertex], Points[B], Points[C], Points[Reflex]))
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	//Clipping only removes reflex vertices,so an ear stays an ear until one of its neighbours is clipped
+	TArray<bool> IsQueued;
+	TArray<int> EarQueue;
+	IsQueued.SetNumZeroed(NumPoints);
+	EarQueue.Reserve(NumPoints * 3);
+	auto QueueIfEar = [&](int Vertex)
+	{
+		if (!IsQueued[Vertex] && IsEar(Vertex))
+		{
+			IsQueued[Vertex] = true;
+			EarQueue.Add(Vertex);
+		}
+	};
+	for (int i = 0; i < NumPoints; i++)
+	{
+		QueueIfEar(i);
+	}
+
+	TArray<bool> IsClipped;
+	IsClipped.SetNumZeroed(NumPoints);
+	int Remaining = NumPoints;
+	//An empty queue before the last triangle means outline is not simple
+	for (int Head = 0; Head < EarQueue.Num() && Remaining >= 3; Head++)
+	{
+		const int Vertex = EarQueue[Head];
+		IsQueued[Vertex] = false;
+		//Neighbours may have changed since it was queued
+		if (IsClipped[Vertex] || !IsEar(Vertex))
+		{
+			continue;
+		}
+
+		const int B = Next[Vertex];
+		const int C = Prev[Vertex];
+		OutIndices.Add(Vertex);
+		OutIndices.Add(B);
+		OutIndices.Add(C);
+
+		//Unlink clipped vertex,only its neighbours can change convexity or ear state
+		Next[C] = B;
+		Prev[B] = C;
+		IsClipped[Vertex] = true;
+		Remaining--;
+		UpdateReflex(B);
+		UpdateReflex(C);
+		QueueIfEar(B);
+		QueueIfEar(C);
+	}
+	return OutIndices.Num() / 3;
+}
@@ -0,0 +1,112 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+
+#include "SplineSweepUpdateSubsystem.h"
+#include "SplineSweepMeshComponent.h"
+#include "SplineSweepStats.h"
+#include "Components/SplineComponent.h"
+#include "Engine/World.h"
+
+void USplineSweepUpdateSubsystem::RequestUpdate(USplineSweepMeshComponent* Component, USplineComponent* Path, float RateOfProgress)
+{
+	if (!Component || !Path)
+	{
+		return;
+	}
+	//Keep time of the first request,so a component updated every frame still gets older
+	if (FRequest* Request = Pending.Find(Component))
+	{
+		Request->Path = Path;
+		Request->Rate = RateOfProgress;
+		NumCollapsedRequests++;
+		return;
+	}
+	FRequest& Request = Pending.Add(Component);
+	Request.Path = Path;
+	Request.Rate = RateOfProgress;
+	Request.RequestTime = FPlatformTime::Seconds();
+}
+
+void USplineSweepUpdateSubsystem::CancelUpdate(USplineSweepMeshComponent* Component)
+{
+	Pending.Remove(Component);
+}
+
+float USplineSweepUpdateSubsystem::ComputePriority(const USplineSweepMeshComponent& Component, const FRequest& Request, double Now) const
+{
+	const float Waited = Now - Request.RequestTime;
+	const bool bVisible = Component.WasRecentlyRendered(RecentlyRenderedSeconds);
+	if (!bVisible && Waited < MaxDeferSeconds)
+	{
+		return -1;
+	}
+
+	float Distance = 0;
+	if (UWorld* World = GetWorld())
+	{
+		float MinDistanceSquared = MAX_flt;
+		for (const FVector& ViewLocation : World->ViewLocationsRenderedLastFrame)
+		{
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, FVector::DistSquared(Component.Bounds.Origin, ViewLocation));
+		}
+		Distance = MinDistanceSquared < MAX_flt ? FMath::Sqrt(MinDistanceSquared) : 0;
+	}
+	//Waiting raises priority,distance lowers it,halved at 10 meters,components out of sight come last
+	return (1 + Waited * 10) / (1 + Distance / 1000) * (bVisible ? 1 : 0.1f);
+}
+
+void USplineSweepUpdateSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SplineSweep_ScheduledUpdates);
+	const double Now = FPlatformTime::Seconds();
+	NumDeferredLastFrame = 0;
+	NumOverBudgetLastFrame = 0;
+	NumProcessedLastFrame = 0;
+
+	TArray<TPair<USplineSweepMeshComponent*, float>> Ready;
+	for (auto It = Pending.CreateIterator(); It; ++It)
+	{
+		USplineSweepMeshComponent* Component = It.Key().Get();
+		if (!Component || !It.Value().Path.IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		It.Value().Priority = ComputePriority(*Component, It.Value(), Now);
+		if (It.Value().Priority < 0)
+		{
+			NumDeferredLastFrame++;
+			continue;
+		}
+		Ready.Emplace(Component, It.Value().Priority);
+	}
+	Ready.Sort([](const TPair<USplineSweepMeshComponent*, float>& A, const TPair<USplineSweepMeshComponent*, float>& B)
+	{
+		return A.Value > B.Value;
+	});
+
+	const double Deadline = Now + BudgetMilliseconds / 1000.0;
+	for (int i = 0; i < Ready.Num(); i++)
+	{
+		//At least one update per frame,so a budget smaller than one update still makes progress
+		if (i > 0 && FPlatformTime::Seconds() >= Deadline)
+		{
+			NumOverBudgetLastFrame = Ready.Num() - i;
+			break;
+		}
+		USplineSweepMeshComponent* Component = Ready[i].Key;
+		const FRequest Request = Pending.FindAndRemoveChecked(Component);
+		Component->ApplyPathUpdate(Request.Path.Get(), Request.Rate);
+		NumProcessedLastFrame++;
+	}
+
+	SET_DWORD_STAT(STAT_SplineSweep_QueueDepth, Pending.Num());
+	SET_DWORD_STAT(STAT_SplineSweep_DeferredUpdates, NumDeferredLastFrame);
+	SET_DWORD_STAT(STAT_SplineSweep_OverBudgetUpdates, NumOverBudgetLastFrame);
+	CSV_CUSTOM_STAT(SplineSweep, QueueDepth, Pending.Num(), ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(SplineSweep, DeferredUpdates, NumDeferredLastFrame, ECsvCustomStatOp::Set);
+}
+
+TStatId USplineSweepUpdateSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(USplineSweepUpdateSubsystem, STATGROUP_Tickables);
+}
@@ -0,0 +1,143 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "Materials/MaterialInterface.h"
+#include "SplineSweepGenerator.h"
+#include "SplineSweepBatchComponent.generated.h"
+
+/**
+ *	Owns many sweeps and packs their geometry into one mesh section per material,so they render as a few draws of one primitive.
+ *	Every sweep keeps a stable vertex range in its sections,updating a sweep with fixed topology only rewrites its range.
+ *	Changes are uploaded once per frame,or when FlushSweeps is called.
+ *	Paths may belong to other actors,each sweep is moved from space of its path into space of the batch.
+ *	The offset is taken when a sweep is added or updated,sweeps are not moved with their paths or the batch in between.
+ */
+UCLASS(meta = (BlueprintSpawnableComponent), Blueprintable)
+class SPLINESWEEPMESH_API USplineSweepBatchComponent : public UProceduralMeshComponent
+{
+	GENERATED_BODY()
+public:
+	USplineSweepBatchComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/**
+	 *	Add a sweep to the batch
+	 *	@param	SplineToSweep		    A spline component reference which is used to sweep along path
+	 *	@param	SplineAsPath		    A spline component reference which is used as path
+	 *	@param	NumberOfSegments		How many segments should be created along path
+	 *	@param	RateOfProgress		    To make grow animation.Rate of grow progress along path
+	 *	@param	SmoothNormal		    Whether should use smoothed normal for side surface,vertex would be shared if use smoothed normal
+	 *	@param	SideMaterial		    Material of side surface,sweeps with the same material share a section
+	 *	@param	CoverMaterial		    Material of covers,only used if path is not a closed loop
+	 *	@return	Handle of the sweep,INDEX_NONE if splines are invalid
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		int AddSweep(USplineComponent* SplineToSweep, USplineComponent* SplineAsPath, int NumberOfSegments, float RateOfProgress, bool SmoothNormal, UMaterialInterface* SideMaterial, UMaterialInterface* CoverMaterial);
+	/**
+	 *	Sweep again along path.Only the vertex range of this sweep is rewritten if its topology does not change
+	 *	@param	Handle					Handle returned by AddSweep
+	 *	@param	Path		            A spline component reference which is used as path
+	 * 	@param	RateOfProgress		    To make grow animation.Rate of grow progress along path
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void UpdateSweep(int Handle, USplineComponent* Path, float RateOfProgress);
+	//Remove a sweep,sweeps after it in its sections are packed down
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void RemoveSweep(int Handle);
+	//Remove every sweep and section
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void ClearSweeps();
+	//Upload pending changes now instead of at the end of the frame
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void FlushSweeps();
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumSweeps() const { return Sweeps.Num(); }
+
+	//Whether collision is created for sections.Read when a section is created
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bCreateCollision = false;
+	//How many path frames are cached between two points of path spline
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "1"))
+		int FrameCacheSamplesPerSegment = 32;
+	//Largest distance in cm between curved profile spline and its tessellated ring.0 reads control points only,set it above 0 to tessellate curved profiles.Read when a sweep is added
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0"))
+		float MaxProfileDeviation = 0;
+
+protected:
+	//One sweep of the batch
+	struct FSweep
+	{
+		TWeakObjectPtr<USplineComponent> Path;
+		//Transform from space of path into space of the batch,taken when sweep is added or updated
+		FTransform PathToBatch;
+		TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> Profile;
+		TSharedPtr<const FSplineSweepFrameCache, ESPMode::ThreadSafe> Frames;
+		FSplineSweepSettings Settings;
+		FSplineSweepMeshBuffers Buffers;
+		//Sections holding side surface and covers
+		int SideSection = INDEX_NONE;
+		int CoverSection = INDEX_NONE;
+	};
+
+	//How much of a section has to be uploaded,larger values include smaller ones
+	enum class ESectionChange : uint8
+	{
+		None,
+		//Vertices were rewritten in place
+		Update,
+		//Parts were appended,arrays are consistent
+		Create,
+		//Ranges moved or changed size,arrays are rebuilt from sweeps
+		Repack,
+	};
+
+	//A range of vertices and indices of one sweep in a section
+	struct FPart
+	{
+		int Handle = INDEX_NONE;
+		bool bCover = false;
+		int FirstVertex = 0;
+		int NumVertices = 0;
+		int FirstIndex = 0;
+		int NumIndices = 0;
+	};
+
+	//Packed geometry of every sweep using one material
+	struct FSection
+	{
+		TWeakObjectPtr<UMaterialInterface> Material;
+		TArray<FVector> Vertices;
+		TArray<int> Indices;
+		TArray<FVector> Normals;
+		TArray<FVector2D> UVs;
+		TArray<FProcMeshTangent> Tangents;
+		TArray<FPart> Parts;
+		ESectionChange Change = ESectionChange::None;
+	};
+
+	TMap<int, FSweep> Sweeps;
+	int NextHandle = 0;
+	//Index of a section is its mesh section index
+	TArray<FSection> Sections;
+	TArray<FColor> EmptyColors;
+
+	//Find section of a material,add one if no sweep uses it yet
+	int FindOrAddSection(UMaterialInterface* Material);
+	//Append side surface or covers of a sweep to a section
+	void AppendPart(int SectionIndex, int Handle, bool bCover);
+	//Copy geometry of a sweep into its range
+	void WritePart(FSection& Section, const FPart& Part) const;
+	//Rebuild arrays of a section from its sweeps
+	void RepackSection(FSection& Section);
+	//Create mesh section from packed arrays of a section
+	void CreatePackedSection(int SectionIndex);
+	//Geometry of a sweep that goes into a part
+	void GetPartGeometry(const FSweep& Sweep, bool bCover, const TArray<FVector>*& OutVertices, const TArray<FVector>*& OutNormals, const TArray<FVector2D>*& OutUVs, const TArray<FProcMeshTangent>*& OutTangents, const TArray<int>*& OutIndices) const;
+	void MarkSection(int SectionIndex, ESectionChange Change);
+	//Transform from space of a path into space of the batch
+	FTransform GetPathToBatch(USplineComponent* Path) const;
+};
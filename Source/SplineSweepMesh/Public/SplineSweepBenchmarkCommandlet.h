@@ -0,0 +1,36 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SplineSweepBenchmarkCommandlet.generated.h"
+
+class FJsonValue;
+
+/**
+ *	Measures sweep generation performance headlessly and writes results as json,to track regressions between plugin versions.
+ *	Usage: UE4Editor-Cmd <Project> -run=SplineSweepBenchmark -nullrhi [-iterations=N] [-output=File.json] [-quick]
+ *	Results are written to Saved/SplineSweepBenchmark if no output is given.-quick only runs the smallest sweep cases.
+ */
+UCLASS()
+class USplineSweepBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	USplineSweepBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+protected:
+	//Transform rings with scalar and vectorized kernels,log points per second of both
+	void BenchmarkRingTransform(int Iterations, TArray<TSharedPtr<FJsonValue>>& OutResults);
+	//Triangulate star shaped covers from 10 to 10k points,half of them reflex
+	void BenchmarkTriangulation(int Iterations, TArray<TSharedPtr<FJsonValue>>& OutResults);
+	/**
+	 *	Create and update sweep meshes over path lengths,numbers of segments,profile sizes,smooth and flat normals,with and without collision.
+	 *	Wall time,triangles per second and heap allocations per call are measured for CreateSweepMesh and UpdatePathSpline.
+	 */
+	void BenchmarkSweep(int Iterations, bool bQuick, TArray<TSharedPtr<FJsonValue>>& OutResults);
+	//Write results with plugin,engine and platform versions
+	bool WriteResults(const FString& Path, int Iterations, const TArray<TSharedPtr<FJsonValue>>& Results) const;
+};
@@ -0,0 +1,137 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SplineComponent.h"
+#include "SplineSweepStats.h"
+
+//A frame sampled along path spline,in local space of path spline
+struct FSplineSweepFrame
+{
+	FVector Location = FVector::ZeroVector;
+	//Unit tangent of path,also used to interpolate location between samples
+	FVector Direction = FVector::ForwardVector;
+	FQuat Rotation = FQuat::Identity;
+	FVector Scale = FVector::OneVector;
+	//Input key of path spline at this frame
+	float InputKey = 0;
+
+	//Build transform matrix used to sweep points,X is path direction,Y and Z are scaled by spline scale
+	FMatrix ToMatrix() const;
+};
+
+//Copy of the path spline data needed to sample frames.Can be read from any thread
+struct SPLINESWEEPMESH_API FSplineSweepPathSnapshot
+{
+	//Only used to identify the path,never dereferenced off game thread
+	const USplineComponent* Path = nullptr;
+	FSplineCurves Curves;
+	FVector DefaultUpVector = FVector::UpVector;
+
+	void Capture(const USplineComponent* InPath);
+	/**
+	 *	Compare control points with an older snapshot of the same path
+	 *	@param	Older				Snapshot the current geometry was built from
+	 *	@param	OutDirtySegments	One flag per spline segment,set if the segment changed shape
+	 *	@return	False if points were added,removed or loop state changed,then every segment is dirty
+	 */
+	bool FindChangedSegments(const FSplineSweepPathSnapshot& Older, TArray<bool>& OutDirtySegments) const;
+	//Spline segment an input key lies in
+	int GetSegmentAtInputKey(float InputKey) const;
+};
+
+/**
+ *	Evaluates frames of a path spline at increasing distances along it,in a single pass.
+ *	Cursors into reparam table and spline curves only move forward,so sampling a whole path costs O(samples + points)
+ *	instead of a binary search per curve and sample.Position,direction,up vector and scale are evaluated from one key per sample.
+ */
+class SPLINESWEEPMESH_API FSplineSweepPathSampler
+{
+public:
+	/**
+	 *	@param	InSnapshot				Path to sample,must outlive the sampler
+	 *	@param	bInRotationMinimizing	Whether frames are carried forward with the least rotation from the first frame,instead of following up vector of every point.Twist of path points after the first one is ignored then
+	 */
+	FSplineSweepPathSampler(const FSplineSweepPathSnapshot& InSnapshot, bool bInRotationMinimizing);
+
+	//Frame at distance along path.Distance must not be shorter than the one of the previous call
+	FSplineSweepFrame Next(float Distance);
+
+private:
+	const FSplineCurves& Curves;
+	FVector DefaultUpVector;
+	bool bRotationMinimizing;
+	//Last point each curve was found at,INDEX_NONE before the first point
+	int ReparamCursor = INDEX_NONE;
+	int PositionCursor = INDEX_NONE;
+	int RotationCursor = INDEX_NONE;
+	int ScaleCursor = INDEX_NONE;
+	//Previous frame,carried forward by rotation minimizing frames
+	bool bHasPrevious = false;
+	FVector PreviousLocation = FVector::ZeroVector;
+	FVector PreviousDirection = FVector::ForwardVector;
+	FVector PreviousUp = FVector::UpVector;
+};
+
+/**
+ *	Table of frames sampled at uniform distance along a path spline.
+ *	The table is rebuilt only when points of the path spline change,every other query is read from it.
+ *	A built table is never modified,so it can be shared with worker threads.
+ */
+class SPLINESWEEPMESH_API FSplineSweepFrameCache
+{
+public:
+	//Whether table was built from the current state of path spline
+	bool IsUpToDate(const USplineComponent* Path, int SamplesPerSegment, bool bRotationMinimizing = false) const;
+	/**
+	 *	Build the table from a copy of path spline
+	 *	@param	Snapshot				Path spline data captured on game thread
+	 *	@param	SamplesPerSegment		How many frames are sampled between two spline points
+	 *	@param	bRotationMinimizing		Whether frames are rotation minimizing instead of following up vector of path points
+	 */
+	void Build(const FSplineSweepPathSnapshot& Snapshot, int SamplesPerSegment, bool bRotationMinimizing = false);
+	bool IsValid() const { return Frames.Num() > 1; }
+
+	float GetSplineLength() const { return SplineLength; }
+	//Unique number of this build,changes whenever the table is rebuilt
+	uint32 GetSerial() const { return Serial; }
+	//Interpolated frame at distance along path.Distance longer than path uses direction of the last spline point
+	FSplineSweepFrame GetFrameAtDistance(float Distance) const;
+	//Transform matrix at distance along path
+	FMatrix GetMatrixAtDistance(float Distance) const { return GetFrameAtDistance(Distance).ToMatrix(); }
+
+	/**
+	 *	Place rings along path by curvature,twist and scale change,walking the cached frames.
+	 *	A span between two rings is accepted while the linear surface between them stays within tolerance of the cached frames.
+	 *	@param	MaxDeviation		Largest distance in cm between linear span and path,including profile points turned and scaled around it
+	 *	@param	MaxAngle			Largest rotation in degrees between two rings
+	 *	@param	ProfileRadius		Largest distance of a profile point from path
+	 *	@param	MinSegments			Spans are never longer than path length divided by this
+	 *	@param	MaxSegments			Tolerance is relaxed until rings fit,then rings are spread evenly
+	 *	@param	OutDistances		Distance along path of every ring,first is 0 and last is path length
+	 */
+	void FindAdaptiveRingDistances(float MaxDeviation, float MaxAngle, float ProfileRadius, int MinSegments, int MaxSegments, TArray<float>& OutDistances) const;
+
+	//Exact frame of path spline at input key,evaluated with a single key the same way USplineComponent does
+	static FSplineSweepFrame EvaluateFrameAtInputKey(const FSplineCurves& Curves, const FVector& DefaultUpVector, float InputKey);
+
+private:
+	TArray<FSplineSweepFrame> Frames;
+	//Frame at the last spline point,used when distance is longer than path
+	FSplineSweepFrame LastPointFrame;
+	float SampleSpacing = 0;
+	float SplineLength = 0;
+	uint32 Serial = 0;
+	//Reports allocated size of the table to "stat SplineSweep"
+	FSplineSweepMemoryCounter MemoryCounter{ ESplineSweepMemoryStat::FrameCache };
+
+	//Whether a straight span between two cached frames stays within tolerance of every frame inside it
+	bool IsSpanWithinTolerance(int Start, int End, float MaxDeviation, float MaxAngle, float ProfileRadius) const;
+
+	//Key of the cached table
+	const USplineComponent* CachedPath = nullptr;
+	uint32 CachedVersion = 0;
+	FVector CachedUpVector = FVector::ZeroVector;
+	int CachedSamplesPerSegment = 0;
+	bool bCachedRotationMinimizing = false;
+};
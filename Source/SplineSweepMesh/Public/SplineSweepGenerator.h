@@ -0,0 +1,167 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "SplineSweepProfile.h"
+#include "SplineSweepFrameCache.h"
+#include "SplineSweepStats.h"
+
+//Geometry of a sweep mesh.Buffers are retained between updates,so updates with fixed topology write in place
+struct SPLINESWEEPMESH_API FSplineSweepMeshBuffers
+{
+	//Points,normals and UVs swept along path,one ring per segment
+	TArray<FVector> SweptPoints;
+	TArray<FVector> SweptNormals;
+	TArray<FVector2D> SweptUVs;
+	//Vertex data of side surface.Section 0
+	TArray<FVector> SideVertices;
+	TArray<int> SideIndices;
+	TArray<FVector> SideNormals;
+	TArray<FVector2D> SideUVs;
+	//Tangents of side surface,empty if tangents are not generated
+	TArray<FProcMeshTangent> SideTangents;
+	//Vertex data of covers.Section 1
+	TArray<FVector> CoverVertices;
+	TArray<int> CoverIndices;
+	TArray<FVector> CoverNormals;
+	TArray<FProcMeshTangent> CoverTangents;
+	//Counts buffer growth since last reset
+	int Allocations = 0;
+	//Input key of path spline each ring was swept at
+	TArray<float> RingKeys;
+	//Distance along path of every ring as fraction of path length,and serial of the frames they were placed with.Adaptive segments only
+	TArray<float> RingFractions;
+	uint32 RingFractionsFrameSerial = 0;
+	//Rings at fixed arc length already swept into the buffers,and serial of the frames they were swept with.Fixed spacing growth only
+	int NumValidFixedRings = 0;
+	uint32 FixedRingsFrameSerial = 0;
+	//Reports allocated size of the buffers to "stat SplineSweep"
+	FSplineSweepMemoryCounter MemoryCounter{ ESplineSweepMemoryStat::Buffers };
+
+	//Swap vertex data with other buffers,indices stay where they are
+	void SwapVertexData(FSplineSweepMeshBuffers& Other);
+	//Swap everything with other buffers
+	void SwapAll(FSplineSweepMeshBuffers& Other);
+	SIZE_T GetAllocatedSize() const;
+	void UpdateMemoryStat() { MemoryCounter.Set(GetAllocatedSize()); }
+
+	//Resize a retained buffer without shrinking its allocation,count it if it has to grow
+	template<typename ElementType>
+	void Resize(TArray<ElementType>& Buffer, int Num)
+	{
+		if (Buffer.Max() < Num)
+		{
+			Allocations++;
+		}
+		Buffer.SetNumUninitialized(Num, false);
+	}
+};
+
+//Settings of a sweep that are fixed when mesh is created
+struct FSplineSweepSettings
+{
+	//How many segments are created along path
+	int NumSegments = 10;
+	//Whether side surface shares vertices between quads
+	bool bSmoothNormal = false;
+	//Whether covers are created at both ends of path
+	bool bHaveCover = false;
+	//Whether collision is created for mesh sections
+	bool bCreateCollision = false;
+	//Whether rings sit at fixed arc length,so growing only appends rings.Otherwise rings are spread over the grown length
+	bool bFixedSpacingGrowth = false;
+	//Whether rings are placed by curvature,twist and scale change of path instead of evenly.NumSegments is not used then.Not used with fixed spacing growth
+	bool bAdaptiveSegments = false;
+	//Largest distance in cm between swept surface and path allowed between two rings
+	float MaxChordDeviation = 0.5f;
+	//Largest rotation in degrees between two rings
+	float MaxSegmentAngle = 5;
+	//Number of segments adaptive placement can not go below or above
+	int MinSegments = 1;
+	int MaxSegments = 1024;
+	//Whether rings are transformed with the vectorized kernel
+	bool bVectorized = true;
+	//Whether rings and quads may be generated on worker threads
+	bool bParallel = true;
+	//Below this number of vertices generation runs serially
+	int ParallelVertexThreshold = 16384;
+	//Whether tangents are generated from path frames and profile direction
+	bool bGenerateTangents = true;
+	//Whether binormals point against V of texture instead of along it
+	bool bFlipTangentY = false;
+
+	bool ShouldRunInParallel(int NumVertices) const { return bParallel && NumVertices >= ParallelVertexThreshold; }
+};
+
+/**
+ *	Generates sweep geometry from a profile and cached path frames.
+ *	Holds no UObject,so it can run on game thread or on a worker thread.
+ */
+class SPLINESWEEPMESH_API FSplineSweepGenerator
+{
+public:
+	FSplineSweepGenerator(const FSplineSweepProfile& InProfile, const FSplineSweepFrameCache& InFrames, const FSplineSweepSettings& InSettings);
+
+	/**
+	 *	Fill every section
+	 *	@param	Rate				Rate of grow progress along path
+	 *	@param	Buffers				Retained buffers to fill
+	 *	@param	bBuildIndices		Whether indices are rebuilt,only needed when topology changes
+	 */
+	void Build(float Rate, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const;
+	//Fill flank surface along path spline.Section 0
+	void BuildSide(float Rate, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const;
+	/**
+	 *	Size buffers and build indices of a new side surface without sweeping,so segments can be filled over several calls.
+	 *	Fixed spacing growth sweeps every ring here,rings depend on those already in the buffers
+	 *	@return	Number of segments along path
+	 */
+	int PrepareSide(float Rate, FSplineSweepMeshBuffers& Buffers) const;
+	//Fill side surface of segments from FirstSegment to LastSegment after PrepareSide,rings at both ends of them included
+	void BuildSideSegments(float Rate, FSplineSweepMeshBuffers& Buffers, int FirstSegment, int LastSegment) const;
+	//Fill two covers at start and end of path.Section 1
+	void BuildCovers(float Rate, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const;
+	//Fill two covers with frames at start and end of path
+	void BuildCoversAt(const FMatrix& M0, const FMatrix& M1, FSplineSweepMeshBuffers& Buffers, bool bBuildIndices) const;
+	/**
+	 *	Sweep again only rings whose input key lies in a changed segment of path,every other ring keeps its shape.
+	 *	Rings are evaluated exactly from the new path,cached frames are not used.
+	 *	@param	Path				Path spline the rings are swept along now
+	 *	@param	DirtySegments		One flag per spline segment,from FSplineSweepPathSnapshot::FindChangedSegments
+	 *	@param	Buffers				Buffers filled by a full build before
+	 *	@param	OutFirstRing		First ring that was swept again
+	 *	@param	OutLastRing			Last ring that was swept again
+	 *	@return	Number of rings swept again
+	 */
+	int UpdateDirtyRings(const FSplineSweepPathSnapshot& Path, const TArray<bool>& DirtySegments, FSplineSweepMeshBuffers& Buffers, int& OutFirstRing, int& OutLastRing) const;
+
+	//Number of segments along path,placed adaptive rings are read from buffers
+	int GetNumSegments(const FSplineSweepMeshBuffers& Buffers) const;
+	//Place rings by tolerance of path if frames changed since they were placed.Adaptive segments only
+	void PlaceAdaptiveRings(FSplineSweepMeshBuffers& Buffers) const;
+
+	//Length of path covered at rate of progress
+	float GetGrownLength(float Rate) const;
+
+	//Sweep points' position and normal along path spline,rings from FirstRing to LastRing.Used to create side surface
+	void SweepPointsAlongSpline(float Rate, FSplineSweepMeshBuffers& Buffers, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs, int FirstRing = 0, int LastRing = INDEX_NONE) const;
+	/**
+	 *	Sweep rings at fixed spacing along path,only rings not already in the buffers and the leading partial ring are swept
+	 *	@return	Index of the first ring that was written
+	 */
+	int SweepPointsAtFixedSpacing(float Rate, FSplineSweepMeshBuffers& Buffers, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs, int& OutNumRings) const;
+	//Transform profile into one ring of output with frame along path
+	void SweepRing(const FSplineSweepFrame& Frame, float V, int Ring, FSplineSweepMeshBuffers& Buffers, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs) const;
+	//Expand swept rings into unshared quads with flat normals,segments from FirstSegment to LastSegment.Used when smoothed normal is off
+	void ExpandSweptPointsIntoQuads(FSplineSweepMeshBuffers& Buffers, int SegmentsNumber, int FirstSegment = 0, int LastSegment = INDEX_NONE) const;
+	//Make side tangents as many as side vertices,or drop them if tangents are not generated
+	void ResizeSideTangents(FSplineSweepMeshBuffers& Buffers) const;
+	//Grow or trim side indices to the number of segments,existing indices are kept
+	void ResizeSideIndices(FSplineSweepMeshBuffers& Buffers, int SegmentsNumber) const;
+
+private:
+	const FSplineSweepProfile& Profile;
+	const FSplineSweepFrameCache& Frames;
+	const FSplineSweepSettings& Settings;
+};
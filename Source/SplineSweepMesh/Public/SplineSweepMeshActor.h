@@ -40,6 +40,9 @@ public:
 	//How many degments should be created along path
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
 		int NumSegments = 10;
+	//Whether points of spline to sweep keep their curve type,curved segments are tessellated if MaxProfileDeviation of the component is above 0.Otherwise every point is made linear
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bCurvedProfile = false;
 	//To make grow animation.Rate of grow progress along path.Should be in[0,1]
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
 		float RateOfProgress = 1;
@@ -48,12 +51,18 @@ public:
 	UPROPERTY(VisibleDefaultsOnly, BlueprintReadWrite, Category = Default)
 		USplineSweepMeshComponent* SweepMeshComponent;
 
-	//Call SweepMeshComponent->CreateSweepMesh();
+	//Call SweepMeshComponent->CreateSweepMesh(),skipped if inputs are unchanged and bSkipUnchangedInputs of the component is set
 	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
 		void CreateSweepMesh();
 	//Call 	SweepMeshComponent->UpdatePathSpline();
 	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
 		void UpdatePathSpline(float Progress);
+	//Call 	SweepMeshComponent->UpdatePathSplineAsync();
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void UpdatePathSplineAsync(float Progress);
+	//Call 	SweepMeshComponent->UpdatePathSplineScheduled();
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void UpdatePathSplineScheduled(float Progress);
 
 
 
@@ -5,45 +5,119 @@
 #include "ProceduralMeshComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "Materials/MaterialInterface.h"
+#include "Engine/EngineTypes.h"
+#include "SplineSweepFrameCache.h"
+#include "SplineSweepProfile.h"
+#include "SplineSweepGenerator.h"
 #include "SplineSweepMeshComponent.generated.h"
 
 
 class USplineComponent;
 
-struct TrianglePoints
+//How rings are placed along path when rate of progress changes
+UENUM(BlueprintType)
+enum class ESplineSweepGrowthMode : uint8
 {
-	FVector pointA = FVector();
-	FVector pointB = FVector();
-	FVector pointC = FVector();
+	//Rings are spread evenly over the grown length,every ring moves when rate changes
+	ScaleSegments,
+	//Rings sit at fixed arc length,growing appends rings and a partial ring at the tip,shrinking trims them
+	FixedSpacing,
+};
 
-public:
-	FORCEINLINE TrianglePoints(FVector A, FVector B, FVector C);
+UENUM(BlueprintType)
+enum class ESplineSweepSegmentMode : uint8
+{
+	//NumberOfSegments rings are spread evenly along path
+	Uniform,
+	//Rings are placed by curvature,twist and scale change of path within tolerance,NumberOfSegments is not used
+	ErrorTolerance,
+};
 
+UENUM(BlueprintType)
+enum class ESplineSweepCollisionMode : uint8
+{
+	//Render triangles are used as collision,cooked again whenever topology changes
+	RenderMesh,
+	//A hidden low resolution sweep is used as collision,section 2
+	ProxyMesh,
+	//A chain of convex hulls,one per low resolution segment,used as simple collision
+	ConvexChain,
 };
 
-struct QuadPoints
+UENUM(BlueprintType)
+enum class ESplineSweepLODMetric : uint8
 {
-	FVector pointA = FVector();
-	FVector pointB = FVector();
-	FVector pointC = FVector();
-	FVector pointD = FVector();
+	//Levels switch by size of bounds on screen,assuming a 90 degree field of view
+	ScreenSize,
+	//Levels switch by distance from bounds to the closest view
+	Distance,
+};
 
-	FVector2D UVa = FVector2D();
-	FVector2D UVb = FVector2D();
-	FVector2D UVc = FVector2D();
-	FVector2D UVd = FVector2D();
+//A coarser detail level generated from the same sweep
+USTRUCT(BlueprintType)
+struct FSplineSweepLOD
+{
+	GENERATED_BODY()
 
-public:
-	FORCEINLINE QuadPoints(
-		FVector A, FVector B, FVector C, FVector D, FVector2D UA,
-		FVector2D UB, FVector2D UC, FVector2D UD);
+	//Level is used while screen size is below this,or distance is above this,see LODMetric
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		float Threshold = 0.1f;
+	//Rings along path as fraction of full detail.Tolerances of adaptive segments are divided by it
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0.01", ClampMax = "1"))
+		float SegmentFraction = 0.5f;
+	//Profile points as fraction of full detail,every n-th point is kept
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0.01", ClampMax = "1"))
+		float ProfileFraction = 0.5f;
 };
 
+//Inputs and results of a sweep built on a worker thread.Also serves as the back buffer of the component
+struct FSplineSweepAsyncBuild
+{
+	//Whether topology is rebuilt,otherwise only vertex data is updated
+	bool bCreate = false;
+	float Rate = 1;
+	//Generation of the component when build was launched,stale results are dropped
+	uint32 Generation = 0;
+	FSplineSweepSettings Settings;
+
+	//Profile points captured on game thread,only used when creating
+	TArray<FVector> ProfilePoints;
+	TArray<FVector> ProfileNormals;
+	//Path data captured on game thread,only used when cached frames are out of date
+	bool bRebuildFrames = false;
+	FSplineSweepPathSnapshot PathSnapshot;
+	int FrameSamplesPerSegment = 32;
+	bool bRotationMinimizingFrames = false;
+	//Hash of inputs of a create,stored with sections when it is applied
+	uint32 InputHash = 0;
+	//Hash of path and rate the build was requested with
+	uint32 PathHash = 0;
+
+	//Read only data shared with the component
+	TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> Profile;
+	TSharedPtr<const FSplineSweepFrameCache, ESPMode::ThreadSafe> Frames;
+	//Filled by worker thread,swapped with buffers of the component when done
+	FSplineSweepMeshBuffers Buffers;
+	//Path the build was requested with,read on game thread only
+	TWeakObjectPtr<USplineComponent> PathSpline;
+
+	//Generate geometry,runs on a worker thread
+	void Execute();
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FSplineSweepBuildEvent, USplineSweepMeshComponent*, Component);
+
 UCLASS(meta = (BlueprintSpawnableComponent), Blueprintable)
 class SPLINESWEEPMESH_API USplineSweepMeshComponent : public UProceduralMeshComponent
 {
 	GENERATED_BODY()
 public:
+	USplineSweepMeshComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	//Material of section 0 is applied to every chunk of side surface too
+	virtual void SetMaterial(int32 ElementIndex, UMaterialInterface* Material) override;
+
 	/**
 	 *	Create spline sweep mesh with two splines
 	 *	@param	SplineToSweep		    A spline component reference which is used to sweep along path
@@ -62,44 +136,390 @@ public:
 	 */
 	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
 		void UpdatePathSpline(USplineComponent* Path ,float RateOfProgress);
+	/**
+	 *	Same as CreateSweepMesh,but skipped if the mesh sections were created from the same inputs,whether bSkipUnchangedInputs is set or not.
+	 *	Sections are saved with the level together with the hash of their inputs,so loaded sections are reused without sweeping again.
+	 *	Inputs of reused sections are kept,the first update or LOD switch creates the mesh from them again.
+	 *	@return	Whether mesh was created
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		bool CreateSweepMeshIfChanged(USplineComponent* SplineToSweep, USplineComponent* SplineAsPath, int NumberOfSegments, float RateOfProgress, bool SmoothNormal, bool CreateCollision);
+	//Whether profile,frames and buffers are in memory.Sections loaded with the level have none until the first update or LOD switch creates the mesh again
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		bool HasSweepState() const { return SweepProfile.IsValid() && PathFrames.IsValid(); }
+	//Hash of splines' points and every setting CreateSweepMesh reads.PathHash is ComputePathHash of path spline and rate
+	uint32 ComputeInputHash(USplineComponent* SweepSpline, int segments, bool SmoothNormal, bool CreateCollision, uint32 PathHash) const;
+	//Hash of path spline's points,rate and every setting UpdatePathSpline reads
+	uint32 ComputePathHash(USplineComponent* PathSpline, float Rate) const;
+	/**
+	 *	Same as CreateSweepMesh,but geometry is generated on a worker thread and applied on a later frame.
+	 *	Splines are captured when the build starts.Requests made while a build is running are merged,only the latest one is built.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void CreateSweepMeshAsync(USplineComponent* SplineToSweep, USplineComponent* SplineAsPath, int NumberOfSegments, float RateOfProgress, bool SmoothNormal, bool CreateCollision);
+	/**
+	 *	Same as UpdatePathSpline,but geometry is generated on a worker thread and applied on a later frame.
+	 *	Requests made while a build is running are merged,only the latest one is built.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void UpdatePathSplineAsync(USplineComponent* Path, float RateOfProgress);
+	/**
+	 *	Same as UpdatePathSpline,but queued with the update subsystem of the world,which runs queued updates within a time budget per frame.
+	 *	Requests made before the update runs are merged,only the latest one is built.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void UpdatePathSplineScheduled(USplineComponent* Path, float RateOfProgress);
+	/**
+	 *	Same as CreateSweepMesh,but spread over frames on game thread within ProgressiveBudgetMilliseconds per frame.
+	 *	Side surface fills in along path one chunk section at a time,covers and collision are created last.
+	 *	Editing spline to sweep restarts it.Path edits and updates requested while building are applied as one update once every chunk is created.Another create cancels it.
+	 *	OnProgressiveBuildFinished is broadcast when every section is created,at once if sections are built from the same inputs already.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void CreateSweepMeshProgressive(USplineComponent* SplineToSweep, USplineComponent* SplineAsPath, int NumberOfSegments, float RateOfProgress, bool SmoothNormal, bool CreateCollision);
+	//Stop the progressive build,sections created so far are kept.OnProgressiveBuildCancelled is broadcast
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void CancelProgressiveBuild();
+	//Whether a progressive build is running
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		bool IsProgressiveBuildPending() const { return ProgressiveBuild.IsSet(); }
+	//Fraction of side chunks of the running progressive build that are created,1 if none is running
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		float GetProgressiveBuildProgress() const;
+	//Whether an asynchronous build is running or waiting to run
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		bool IsAsyncBuildPending() const { return bAsyncBuildInFlight || PendingAsyncRequest.IsSet(); }
+	/**
+	 *	Number of times the retained mesh buffers had to grow during the last UpdatePathSpline.
+	 *	Stays 0 once topology is fixed, updates then write in place without heap allocations.
+	 */
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetLastUpdateAllocations() const { return LastUpdateAllocations; }
+	//Number of creates and updates skipped because their inputs matched the mesh sections
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumSkippedBuilds() const { return NumSkippedBuilds; }
+	//Detail level in the mesh sections,0 is full detail
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetActiveLOD() const { return ActiveLOD; }
+	//Number of rings swept along path by the last build,including the ring at the end of path
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumRings() const { return MeshBuffers.RingKeys.Num(); }
+
+	//How rings follow rate of progress.Read by CreateSweepMesh
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		ESplineSweepGrowthMode GrowthMode = ESplineSweepGrowthMode::ScaleSegments;
+	//How rings are placed along path.Read by CreateSweepMesh,error tolerance is not used with fixed spacing growth
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		ESplineSweepSegmentMode SegmentMode = ESplineSweepSegmentMode::Uniform;
+	//Largest distance in cm between swept surface and the true sweep,between two rings
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0.01", EditCondition = "SegmentMode == ESplineSweepSegmentMode::ErrorTolerance"))
+		float MaxChordDeviation = 0.5f;
+	//Largest rotation in degrees between two rings,bending and twisting
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0.1", ClampMax = "180", EditCondition = "SegmentMode == ESplineSweepSegmentMode::ErrorTolerance"))
+		float MaxSegmentAngle = 5;
+	//Fewest segments placed along path with error tolerance
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "1", EditCondition = "SegmentMode == ESplineSweepSegmentMode::ErrorTolerance"))
+		int MinAdaptiveSegments = 1;
+	//Most segments placed along path with error tolerance,tolerance is relaxed to fit
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "1", EditCondition = "SegmentMode == ESplineSweepSegmentMode::ErrorTolerance"))
+		int MaxAdaptiveSegments = 1024;
+	//What is used as collision when CreateCollision is true.Read by CreateSweepMesh,proxies are cooked with async cooking
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|Collision")
+		ESplineSweepCollisionMode CollisionMode = ESplineSweepCollisionMode::RenderMesh;
+	//Segments of collision proxy along path
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|Collision", meta = (ClampMin = "1", EditCondition = "CollisionMode != ESplineSweepCollisionMode::RenderMesh"))
+		int CollisionSegments = 8;
+	//Profile points of collision proxy,profile is decimated down to this
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|Collision", meta = (ClampMin = "3", EditCondition = "CollisionMode != ESplineSweepCollisionMode::RenderMesh"))
+		int CollisionProfilePoints = 8;
+	//Shortest time in seconds between two cooks of collision proxy while updating,the latest state is cooked when it is over
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|Collision", meta = (ClampMin = "0", EditCondition = "CollisionMode != ESplineSweepCollisionMode::RenderMesh"))
+		float CollisionUpdateInterval = 0.2f;
+	//Coarser levels after full detail,ordered from near to far.Empty disables LOD switching
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|LOD")
+		TArray<FSplineSweepLOD> LODs;
+	//What thresholds of LODs are compared with
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|LOD")
+		ESplineSweepLODMetric LODMetric = ESplineSweepLODMetric::ScreenSize;
+	//Fraction of a threshold the view has to move back past it before the level switches back
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|LOD", meta = (ClampMin = "0", ClampMax = "0.9"))
+		float LODHysteresis = 0.1f;
+	//How many path frames are cached between two points of path spline.Rings between cached frames are interpolated
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "1"))
+		int FrameCacheSamplesPerSegment = 32;
+	//Whether rings keep the least rotation from the start of path instead of following up vector of path points,avoids flips on paths that turn over.Twist set on path points after the first one is ignored
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bRotationMinimizingFrames = false;
+	//Whether rings are transformed with the vectorized kernel,4 profile points per batch
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bVectorizedSweep = true;
+	//Whether creates and updates return at once when splines,rate and settings are the same as the mesh sections were built from.Materials are not inputs
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bSkipUnchangedInputs = true;
+	//Whether UpdatePathSpline sweeps again only rings in segments whose path points moved,when rate is unchanged.Not used with fixed spacing growth
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bIncrementalPathEdits = true;
+	//Whether rings and quads may be generated on worker threads.Output is identical to serial generation
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bParallelSweep = true;
+	//Below this number of vertices the sweep runs serially,task overhead would outweigh the work
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0", EditCondition = "bParallelSweep"))
+		int ParallelVertexThreshold = 16384;
+	//Whether tangents are written from path frames and profile direction,so normal mapped materials need no CalculateTangentsForMesh
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		bool bGenerateTangents = true;
+	//Whether binormals point against V of texture,for normal maps with the other green channel convention
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (EditCondition = "bGenerateTangents"))
+		bool bFlipTangentY = false;
+	//Largest distance in cm between curved profile spline and its tessellated ring.Straight segments stay two vertices,arcs get as many as needed.0 reads control points only,set it above 0 to tessellate curved profiles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0"))
+		float MaxProfileDeviation = 0;
+	//Segments per side section.Long paths are split into sections,updates only upload sections with changed rings.Sections share bounds and scene proxy of this component,they are not culled on their own.0 keeps the whole side surface in section 0.Read when mesh sections are created
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0"))
+		int ChunkSegments = 0;
+	//Time in milliseconds a progressive build spends per frame.At least one chunk is built every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|Progressive", meta = (ClampMin = "0"))
+		float ProgressiveBudgetMilliseconds = 4;
+	//Segments per side section of progressive builds when ChunkSegments is 0
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep|Progressive", meta = (ClampMin = "1"))
+		int ProgressiveChunkSegments = 256;
+	//Broadcast when a progressive build created every section
+	UPROPERTY(BlueprintAssignable, Category = "SplineSweep|Progressive")
+		FSplineSweepBuildEvent OnProgressiveBuildFinished;
+	//Broadcast when a progressive build is cancelled or replaced by another create
+	UPROPERTY(BlueprintAssignable, Category = "SplineSweep|Progressive")
+		FSplineSweepBuildEvent OnProgressiveBuildCancelled;
 
 
 protected:
-	//Store if use smooth normal
-	bool bUseSmoothNormal;
-	//If spline of path is closed loop,two covers will be created
-	bool bHaveCover;
-	//Store the number of segments
-	int NumSegments;
-	//Store points' positions of spline to sweep
-	TArray<FVector> SweepPoints;
-	//Store points' normals of spline to sweep
-	TArray<FVector> SweepPointNormals;
-	//Store spline area triangles of spline to sweep
-	TArray<TrianglePoints> CoverTriangles;
-
-	//Create mesh sections
-	//Create flank surface along path spline.Section 0
-	void CreateSideQuads(USplineComponent* PathSpline, USplineComponent* SweepSpline, int SegmentsNumber, float Rate, bool bSmooth, bool CreateCollision);
-	//Create two covers surface if path spline is not closed loop.Section 1
-	void CreateCoverTriangles(USplineComponent* PathSpline, USplineComponent* SweepSpline, float Rate, bool CreateCollision);
-
-	//Update mesh section
-	//Update flank surface along path spline.Section 0
-	void UpdateSideQuads(USplineComponent* path, float Rate);
-	//Update two covers surface position if have covers.Section 1
-	void UpdateCoverTriangles(USplineComponent* path, float Rate);
-
-	//Sweep points' position and normal along path spline.Used to create side surface
-	void SweepPointsAlongSpline(USplineComponent* path, TArray<FVector>& PointsToSweep, TArray<FVector>& NormalsToSweep, int SegmentsNumber, float Rate, TArray<FVector>& OutPoints, TArray<FVector>& OutNormal, TArray<FVector2D>& OutUVs);
-	//Use cross to find triangle in the spline area.Used to create cover
-	TrianglePoints FindAndRemoveFirstTriangleInSplineArea(TArray<FVector>& points);
-	//Convert a spline area into triangles to create cover
-	TArray<TrianglePoints> ConvertSplineIntoTriangle(TArray<FVector>& points);
+	//A request waiting for the running asynchronous build to finish
+	struct FPendingSweepRequest
+	{
+		bool bCreate = false;
+		TWeakObjectPtr<USplineComponent> SweepSpline;
+		TWeakObjectPtr<USplineComponent> PathSpline;
+		int NumberOfSegments = 0;
+		float Rate = 1;
+		bool bSmoothNormal = false;
+		bool bCreateCollision = false;
+		uint32 InputHash = 0;
+		uint32 PathHash = 0;
+	};
+
+	//Hash of inputs the mesh sections were created from,saved with the sections.0 if sections changed since
+	UPROPERTY()
+		uint32 SectionsInputHash = 0;
+
+	//Inputs and progress of a create spread over frames
+	struct FProgressiveBuildState
+	{
+		TWeakObjectPtr<USplineComponent> SweepSpline;
+		TWeakObjectPtr<USplineComponent> PathSpline;
+		int NumberOfSegments = 0;
+		float Rate = 1;
+		bool bSmoothNormal = false;
+		bool bCreateCollision = false;
+		uint32 InputHash = 0;
+		uint32 PathHash = 0;
+		//Whether settings,profile,frames and indices are set up for the inputs
+		bool bPrepared = false;
+		int NumSegments = 0;
+		//Next side chunk to sweep and create
+		int NextChunk = 0;
+		int NumChunks = 0;
+		//Edit state of splines when chunks started,spline to sweep is hashed again only when it changes
+		uint32 SweepVersion = 0;
+		uint32 PathVersion = 0;
+		//Update requested while building,applied once every chunk is created
+		bool bUpdatePending = false;
+		TWeakObjectPtr<USplineComponent> UpdatePath;
+		float UpdateRate = 1;
+	};
+	TOptional<FProgressiveBuildState> ProgressiveBuild;
+
+	//Inputs of saved sections reused by CreateSweepMeshIfChanged,to create the mesh again when it is first updated
+	TOptional<FPendingSweepRequest> SavedSectionsRequest;
+
+	//Hash of inputs of the last create,0 if sections were updated since.Kept across LOD switches,another create would pick the same level
+	uint32 BuiltInputHash = 0;
+	//Hash of path and rate the sections were last built with,0 if unknown
+	uint32 BuiltPathHash = 0;
+	//Creates and updates skipped by input hash
+	int NumSkippedBuilds = 0;
+
+	//Settings of the active LOD
+	FSplineSweepSettings SweepSettings;
+	//Settings and profile of full detail,fixed when mesh was created.LODs are derived from them
+	FSplineSweepSettings BaseSettings;
+	TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> BaseProfile;
+	int ActiveLOD = 0;
+	//Path the mesh was last built along,to generate another LOD
+	TWeakObjectPtr<USplineComponent> SweepPath;
+	//Store points' positions and normals of spline to sweep at the active LOD,as structure of arrays,and triangles of covers.Interned,shared with other components
+	TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> SweepProfile;
+	//Frames sampled along path spline,rebuilt only when path spline changes
+	TSharedPtr<const FSplineSweepFrameCache, ESPMode::ThreadSafe> PathFrames;
+	//Path points the current geometry was swept along,compared to find edited segments
+	FSplineSweepPathSnapshot BuiltPathSnapshot;
+	//Rate of progress the current geometry was built with
+	float LastRate = 1;
+	//Retained buffers,sized once on create and filled in place by every update
+	FSplineSweepMeshBuffers MeshBuffers;
+	//Side surface of one chunk,retained between updates
+	struct FSideChunk
+	{
+		TArray<FVector> Vertices;
+		TArray<int> Indices;
+		TArray<FVector> Normals;
+		TArray<FVector2D> UVs;
+		TArray<FProcMeshTangent> Tangents;
+	};
+	TArray<FSideChunk> SideChunks;
+	//Positions of every section with collision,passed to physics once per update
+	TArray<FVector> RenderCollisionVertices;
+	//Segments per chunk the sections were created with,0 if side surface is one section
+	int ActiveChunkSegments = 0;
+	//Rings changed by the last update,INDEX_NONE last ring means every ring
+	int DirtyFirstRing = 0;
+	int DirtyLastRing = INDEX_NONE;
+	//Tessellated ring of the spline to sweep,reused until the spline or tolerance changes
+	TWeakObjectPtr<USplineComponent> TessellatedProfileSpline;
+	uint32 TessellatedProfileVersion = 0;
+	float TessellatedProfileDeviation = -1;
+	TArray<FVector> TessellatedProfilePoints;
+	TArray<FVector> TessellatedProfileNormals;
+	//Always empty,passed for unused vertex streams
+	TArray<FVector2D> EmptyUVs;
+	TArray<FVector> EmptyNormals;
+	TArray<FColor> EmptyColors;
+	TArray<FProcMeshTangent> EmptyTangents;
+	//Counts buffer growth during the last update
+	int LastUpdateAllocations = 0;
+
+	//Back buffer of asynchronous builds,reused so steady updates do not allocate
+	TSharedPtr<FSplineSweepAsyncBuild, ESPMode::ThreadSafe> AsyncBuild;
+	//Latest request made while a build is running
+	TOptional<FPendingSweepRequest> PendingAsyncRequest;
+	bool bAsyncBuildInFlight = false;
+	//Increased by every synchronous build,so results of older asynchronous builds are dropped
+	uint32 BuildGeneration = 0;
+
+	//Collision mode fixed when mesh was created
+	ESplineSweepCollisionMode ActiveCollisionMode = ESplineSweepCollisionMode::RenderMesh;
+	//Collision flags of the component before a collision proxy overrode them
+	bool bCollisionFlagsOverridden = false;
+	bool bUserUseAsyncCooking = false;
+	bool bUserUseComplexAsSimpleCollision = true;
+	//Decimated profile and buffers of collision proxy
+	TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> CollisionProfile;
+	FSplineSweepSettings CollisionSettings;
+	FSplineSweepMeshBuffers CollisionBuffers;
+	TArray<FVector> CollisionVertices;
+	TArray<int> CollisionIndices;
+	TArray<TArray<FVector>> CollisionConvexes;
+	//Latest state waiting to be cooked
+	TWeakObjectPtr<USplineComponent> CollisionPath;
+	float CollisionRate = 1;
+	float LastCollisionUpdateTime = -MAX_flt;
+	FTimerHandle CollisionUpdateTimer;
+
+	//Fix settings,profile,LOD and frames of a new mesh
+	void SetupSweep(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, bool SmoothNormal, bool CreateCollision);
+	//Create after inputs were hashed
+	void BuildSweepMesh(USplineComponent* SweepSpline, USplineComponent* PathSpline, int segments, float Rate, bool SmoothNormal, bool CreateCollision, uint32 PathHash, uint32 InputHash);
+	//Create the mesh again from inputs of saved sections if it has no generator state.Returns whether state is in memory
+	bool RestoreSweepState();
+	//Whether sections are built from these inputs and no other build is waiting.Saved sections have no generator state,they only count if bAllowSavedSections
+	bool IsBuiltFrom(uint32 InputHash, bool bAllowSavedSections) const;
+	//Whether sections are built along this path at this rate and no other build is waiting
+	bool IsBuiltAlong(USplineComponent* Path, uint32 PathHash) const;
+	//Record a build skipped by input hash
+	void CountSkippedBuild();
+	//Drop update queued with the update subsystem
+	void CancelScheduledUpdate();
+	//UpdatePathSpline without dropping the queued update,run by the update subsystem once it dequeued it
+	void ApplyPathUpdate(USplineComponent* Path, float Rate);
+	friend class USplineSweepUpdateSubsystem;
+	//Build steps of progressive build until the budget of this frame is spent
+	void StepProgressiveBuild();
+	//Clear sections and set up a new mesh for the inputs of progressive build
+	void PrepareProgressiveBuild(USplineComponent* SweepSpline, USplineComponent* PathSpline);
+	//Create covers and collision of progressive build and broadcast that it finished
+	void FinishProgressiveBuild(USplineComponent* PathSpline);
+	//Stop ticking every frame once progressive build is over
+	void EndProgressiveBuild();
+	//Create mesh sections from retained buffers.Section 0 is flank surface,section 1 are covers,section 2 is the hidden collision proxy.Further side chunks start at section 3
+	void CreateMeshSections();
+	//Mesh section of a chunk of side surface,sections 1 and 2 are taken by covers and collision proxy
+	static int GetChunkSection(int Chunk) { return Chunk == 0 ? 0 : Chunk + 2; }
+	//Number of chunks the side surface in the retained buffers splits into
+	int GetNumSideChunks() const;
+	//Copy vertices of one chunk out of the retained buffers,indices are rebased onto the chunk
+	void FillSideChunk(int Chunk, bool bIndices);
+	//Create a section per chunk,sections of chunks no longer needed are cleared.Collision is cooked by the last chunk if bCookCollision
+	void CreateSideChunkSections(bool bCollision, bool bCookCollision);
+	//Create section of one chunk from the retained buffers.Collision is enabled on it,but only cooked if bCookCollision
+	void CreateSideChunkSection(int Chunk, bool bCollision, bool bCookCollision);
+	//Update sections of chunks holding dirty rings.Returns false if topology changed and chunks have to be created
+	bool UpdateSideChunkSections();
+	//Set collision flag of a section without cooking it
+	void EnableSectionCollision(int Section, bool bCollision);
+	//Whether render sections are used as collision
+	bool UsesRenderCollision() const { return SweepSettings.bCreateCollision && ActiveCollisionMode == ESplineSweepCollisionMode::RenderMesh && ActiveLOD == 0; }
+	//Whether a collision proxy is built instead of using render sections.Render mesh collision is a full detail proxy while a coarser level is shown
+	bool UsesCollisionProxy() const { return SweepSettings.bCreateCollision && (ActiveCollisionMode != ESplineSweepCollisionMode::RenderMesh || ActiveLOD != 0); }
+	//Fix collision mode of a new mesh before its sections are created.Proxies override cooking flags of the component,leaving them restores the flags
+	void ApplyCollisionMode();
+	//Decimate profile and build collision proxy for a new mesh
+	void CreateCollisionProxy(USplineComponent* Path, float Rate);
+	//Build collision proxy now,or when update interval is over
+	void RequestCollisionUpdate(USplineComponent* Path, float Rate);
+	//Build collision proxy from the latest requested state
+	void UpdateCollisionProxy();
+	//Update mesh sections from retained buffers,sections whose vertex count changed are recreated
+	void UpdateMeshSections();
+	//Update vertices of a section without moving collision
+	void UpdateSectionVertices(int Section, const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<FVector2D>& UVs, const TArray<FProcMeshTangent>& Tangents);
+	//Move vertices of render collision of every section at once
+	void UpdateRenderCollisionVertices();
+	//Rebuild cached frames if path spline changed
+	void UpdatePathFrames(USplineComponent* Path);
+	//Sweep again only rings in edited segments of path.Returns false if a full update is needed
+	bool UpdateEditedSegments(USplineComponent* Path, float Rate);
+	//Derive settings and profile of a LOD from full detail
+	void ApplyLOD(int LOD);
+	//LOD wanted by the closest view rendered last frame
+	int ComputeDesiredLOD() const;
+	//Generate the mesh again at another LOD
+	void SwitchLOD(int LOD);
+	//Copy growth and segment modes of this component into sweep settings,they are fixed when mesh is created
+	void ApplySegmentationSettings(FSplineSweepSettings& Settings) const;
+	//Copy flags of this component into sweep settings
+	void ApplyPerformanceSettings(FSplineSweepSettings& Settings) const;
+
+	//Queue a request,or launch it if no build is running
+	void RequestAsyncBuild(const FPendingSweepRequest& Request);
+	//Capture splines and start generating on a worker thread
+	void LaunchAsyncBuild(const FPendingSweepRequest& Request);
+	//Swap finished back buffer onto the component.Game thread
+	void FinishAsyncBuild();
+
+
+public:
 	//Get local positions of all points of spline 
-	TArray<FVector> GetSplinePointsLocation(USplineComponent* spline);
+	static TArray<FVector> GetSplinePointsLocation(USplineComponent* spline);
 	//Get local normals of all points of spline 
-	TArray<FVector> GetSplinePointsNormal(USplineComponent* spline);
-	//Get transform matrix along spline at distance
-	FMatrix GetMatrixInSplineDistance(USplineComponent* spline, float distance)const;
+	static TArray<FVector> GetSplinePointsNormal(USplineComponent* spline);
+	/**
+	 *	Get local positions and normals of a curved spline,segments are subdivided until they are within tolerance
+	 *	@param	spline				Spline to sweep
+	 *	@param	MaxDeviation		Largest distance in cm between spline and the straight edges between output points.0 outputs control points only
+	 *	@param	OutPoints			Control points and points added on curved segments,in order along spline
+	 *	@param	OutNormals			Normals of side surface at each point
+	 */
+	static void TessellateSplinePoints(USplineComponent* spline, float MaxDeviation, TArray<FVector>& OutPoints, TArray<FVector>& OutNormals);
+
+protected:
+	//Tessellated ring of spline to sweep,cached until spline changes
+	void GetProfilePoints(USplineComponent* spline, TArray<FVector>& OutPoints, TArray<FVector>& OutNormals);
 };
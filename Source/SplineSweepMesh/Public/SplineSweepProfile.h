@@ -0,0 +1,59 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *	Points and normals of the spline to sweep,stored as structure of arrays.
+ *	Arrays are padded with zeros to a multiple of 4 so a whole ring can be transformed with vector registers.
+ */
+struct SPLINESWEEPMESH_API FSplineSweepProfile
+{
+public:
+	//Replace profile with points and normals of spline to sweep
+	void SetPoints(const TArray<FVector>& Points, const TArray<FVector>& Normals);
+	void Reset();
+
+	int Num() const { return NumPoints; }
+	//Largest distance of a profile point from origin of profile spline
+	float GetRadius() const { return Radius; }
+	FVector GetPoint(int Index) const { return FVector(X[Index], Y[Index], Z[Index]); }
+	FVector GetNormal(int Index) const { return FVector(NX[Index], NY[Index], NZ[Index]); }
+	//Direction of profile at a point,from previous to next point around the closed profile.Not normalized
+	FVector GetDirection(int Index) const { return GetPoint(Index + 1 < NumPoints ? Index + 1 : 0) - GetPoint(Index > 0 ? Index - 1 : NumPoints - 1); }
+	//Texture coordinate around profile,[0,1) by point index
+	float GetU(int Index) const { return U[Index]; }
+	//Whether profile was set from exactly these points and normals
+	bool Equals(const TArray<FVector>& Points, const TArray<FVector>& Normals) const;
+	//Copy points back into an array of structures
+	void GetPoints(TArray<FVector>& OutPoints) const;
+	//Triangulate spline area once,covers then only reference profile points by index
+	void TriangulateCover();
+	//Three indices into profile points per cover triangle
+	const TArray<int>& GetCoverTriangles() const { return CoverTriangles; }
+	//1 if cover triangles wind around +X of profile space,-1 if around -X
+	float GetCoverWinding() const { return CoverWinding; }
+
+	/**
+	 *	Transform every point of profile by matrix and renormalize transformed normals,4 points per batch
+	 *	@param	M				Frame of the ring
+	 *	@param	OutPoints		Receives Num() transformed points
+	 *	@param	OutNormals		Receives Num() transformed unit normals,zero if degenerated
+	 */
+	void TransformRing(const FMatrix& M, FVector* OutPoints, FVector* OutNormals) const;
+	//Reference implementation transforming one point at a time,kept to validate and benchmark the vector kernel
+	void TransformRingScalar(const FMatrix& M, FVector* OutPoints, FVector* OutNormals) const;
+
+private:
+	int NumPoints = 0;
+	float Radius = 0;
+	TArray<float> X;
+	TArray<float> Y;
+	TArray<float> Z;
+	TArray<float> NX;
+	TArray<float> NY;
+	TArray<float> NZ;
+	TArray<float> U;
+	TArray<int> CoverTriangles;
+	float CoverWinding = 1;
+};
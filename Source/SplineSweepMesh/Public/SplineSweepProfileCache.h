@@ -0,0 +1,49 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SplineSweepProfile.h"
+
+/**
+ *	Interned sweep profiles,keyed by a hash of points and normals.
+ *	Components sweeping the same cross section share one profile and its cover triangulation by reference.
+ *	Profiles are held weakly,so a profile is freed when the last component using it lets go.Safe to use from any thread.
+ */
+class SPLINESWEEPMESH_API FSplineSweepProfileCache
+{
+public:
+	static FSplineSweepProfileCache& Get();
+
+	/**
+	 *	Find a profile built from the same points,or build and intern a new one
+	 *	@param	Points			Points of spline to sweep
+	 *	@param	Normals			Normals of side surface at points
+	 *	@param	bWithCover		Whether cover triangulation is needed
+	 */
+	TSharedRef<const FSplineSweepProfile, ESPMode::ThreadSafe> FindOrCreate(const TArray<FVector>& Points, const TArray<FVector>& Normals, bool bWithCover);
+	/**
+	 *	Find or build a profile keeping every n-th point of another one,used for lower detail sweeps
+	 *	@param	Profile			Full detail profile
+	 *	@param	MaxPoints		Most points kept,never below 3 so the outline stays closed
+	 *	@param	bWithCover		Whether cover triangulation is needed
+	 */
+	TSharedRef<const FSplineSweepProfile, ESPMode::ThreadSafe> FindOrCreateDecimated(const FSplineSweepProfile& Profile, int MaxPoints, bool bWithCover);
+	//Number of profiles still used by someone
+	int GetNumProfiles() const;
+
+private:
+	struct FEntry
+	{
+		TWeakPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> Profile;
+		bool bWithCover = false;
+	};
+
+	mutable FCriticalSection Lock;
+	//Entries with the same hash are compared point by point
+	TMultiMap<uint32, FEntry> Profiles;
+	//Expired entries are removed every this many insertions
+	int InsertionsSincePrune = 0;
+
+	//Find a live profile equal to points,lock must be held
+	TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> FindLocked(uint32 Hash, const TArray<FVector>& Points, const TArray<FVector>& Normals, bool bWithCover) const;
+};
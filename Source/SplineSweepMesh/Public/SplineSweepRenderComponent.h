@@ -0,0 +1,83 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/MeshComponent.h"
+#include "Components/SplineComponent.h"
+#include "PackedNormal.h"
+#include "SplineSweepGenerator.h"
+#include "SplineSweepRenderComponent.generated.h"
+
+//Vertex data of one section in the layout of the GPU buffers,handed over to the render thread without another copy
+struct FSplineSweepRenderSection
+{
+	TArray<FVector> Positions;
+	//TangentX and TangentZ of each vertex,sign of binormal in W of TangentZ
+	TArray<FPackedNormal> Tangents;
+	TArray<FVector2DHalf> UVs;
+	//Only filled when topology changed,buffers keep their indices otherwise
+	TArray<uint32> Indices;
+};
+
+//Every section of a sweep,section 0 is side surface and section 1 are covers
+struct FSplineSweepRenderData
+{
+	FSplineSweepRenderSection Sections[2];
+};
+
+/**
+ *	Renders a sweep with its own scene proxy instead of procedural mesh sections.
+ *	Generated vertices are packed once into the GPU layout,positions as floats,tangents as packed normals and UVs as halves,
+ *	and the render thread writes them straight into locked vertex buffers.Has no collision.
+ */
+UCLASS(meta = (BlueprintSpawnableComponent), Blueprintable)
+class SPLINESWEEPMESH_API USplineSweepRenderComponent : public UMeshComponent
+{
+	GENERATED_BODY()
+public:
+	/**
+	 *	Create spline sweep mesh with two splines
+	 *	@param	SplineToSweep		    A spline component reference which is used to sweep along path
+	 *	@param	SplineAsPath		    A spline component reference which is used as path
+	 *	@param	NumberOfSegments		How many segments should be created along path
+	 *	@param	RateOfProgress		    To make grow animation.Rate of grow progress along path
+	 *	@param	SmoothNormal		    Whether should use smoothed normal for side surface,vertex would be shared if use smoothed normal
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void CreateSweepMesh(USplineComponent* SplineToSweep, USplineComponent* SplineAsPath, int NumberOfSegments, float RateOfProgress, bool SmoothNormal);
+	/**
+	 *	Sweep again along path and upload vertices to the existing scene proxy
+	 *	@param	Path		            A spline component reference which is used as path
+	 * 	@param	RateOfProgress		    To make grow animation.Rate of grow progress along path
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void UpdatePathSpline(USplineComponent* Path, float RateOfProgress);
+
+	//How many path frames are cached between two points of path spline
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "1"))
+		int FrameCacheSamplesPerSegment = 32;
+	//Largest distance in cm between curved profile spline and its tessellated ring.0 reads control points only,set it above 0 to tessellate curved profiles
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "SplineSweep", meta = (ClampMin = "0"))
+		float MaxProfileDeviation = 0;
+
+	//UPrimitiveComponent interface
+	virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+	//UMeshComponent interface,material 0 is side surface and material 1 are covers
+	virtual int32 GetNumMaterials() const override { return 2; }
+
+protected:
+	TSharedPtr<const FSplineSweepProfile, ESPMode::ThreadSafe> SweepProfile;
+	TSharedPtr<const FSplineSweepFrameCache, ESPMode::ThreadSafe> PathFrames;
+	FSplineSweepSettings SweepSettings;
+	FSplineSweepMeshBuffers MeshBuffers;
+	//Bounds of the last generated vertices in local space
+	FBox LocalBox = FBox(ForceInit);
+	//Whether topology changed since the scene proxy was created,a new proxy is needed then
+	bool bTopologyDirty = false;
+
+	//Pack retained buffers into the GPU layout
+	TUniquePtr<FSplineSweepRenderData> PackRenderData(bool bWithIndices) const;
+	//Write new vertices into buffers of the scene proxy,or recreate render state if topology changed
+	void SendRenderData();
+};
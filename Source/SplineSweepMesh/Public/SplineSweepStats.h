@@ -0,0 +1,71 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+//Shown with "stat SplineSweep"
+DECLARE_STATS_GROUP(TEXT("SplineSweep"), STATGROUP_SplineSweep, STATCAT_Advanced);
+
+//Whole calls of the component
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Sweep Mesh"), STAT_SplineSweep_CreateSweepMesh, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Path Spline"), STAT_SplineSweep_UpdatePathSpline, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Async Build (worker)"), STAT_SplineSweep_AsyncBuild, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Progressive Build"), STAT_SplineSweep_ProgressiveBuild, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+//Stages of a build
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Read Splines"), STAT_SplineSweep_ReadSplines, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Evaluate Frames"), STAT_SplineSweep_EvaluateFrames, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Sweep Points"), STAT_SplineSweep_SweepPoints, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Expand Quads"), STAT_SplineSweep_ExpandQuads, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Triangulate Cover"), STAT_SplineSweep_TriangulateCover, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Covers"), STAT_SplineSweep_BuildCovers, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Create Mesh Section"), STAT_SplineSweep_CreateMeshSection, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Mesh Section"), STAT_SplineSweep_UpdateMeshSection, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Cook Collision"), STAT_SplineSweep_CookCollision, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+//Update scheduler
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Scheduled Updates"), STAT_SplineSweep_ScheduledUpdates, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Update Queue Depth"), STAT_SplineSweep_QueueDepth, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Deferred Updates"), STAT_SplineSweep_DeferredUpdates, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Over Budget Updates"), STAT_SplineSweep_OverBudgetUpdates, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+//Input hashing
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hash Inputs"), STAT_SplineSweep_HashInputs, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Skipped Builds"), STAT_SplineSweep_SkippedBuilds, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+//Memory held between builds
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Retained Buffers"), STAT_SplineSweep_BufferMemory, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Frame Caches"), STAT_SplineSweep_FrameCacheMemory, STATGROUP_SplineSweep, SPLINESWEEPMESH_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SPLINESWEEPMESH_API, SplineSweep);
+
+//Time a stage in stats,Unreal Insights and csv profiles.Stage is the name after STAT_SplineSweep_
+#define SPLINESWEEP_SCOPE(Stage) \
+	SCOPE_CYCLE_COUNTER(STAT_SplineSweep_##Stage); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(SplineSweep_##Stage); \
+	CSV_SCOPED_TIMING_STAT(SplineSweep, Stage)
+
+//Which memory stat a counter reports to
+enum class ESplineSweepMemoryStat : uint8
+{
+	Buffers,
+	FrameCache,
+};
+
+/**
+ *	Memory reported to stats by one owner of retained data.
+ *	Copies start from zero and the destructor takes back what was reported,so every byte is reported once.
+ */
+struct SPLINESWEEPMESH_API FSplineSweepMemoryCounter
+{
+	explicit FSplineSweepMemoryCounter(ESplineSweepMemoryStat InStat) : Stat(InStat) {}
+	FSplineSweepMemoryCounter(const FSplineSweepMemoryCounter& Other) : Stat(Other.Stat) {}
+	FSplineSweepMemoryCounter& operator=(const FSplineSweepMemoryCounter& Other) { return *this; }
+	~FSplineSweepMemoryCounter() { Set(0); }
+
+	//Replace the amount reported by this owner
+	void Set(SIZE_T Size);
+
+private:
+	ESplineSweepMemoryStat Stat;
+	SIZE_T Reported = 0;
+};
@@ -0,0 +1,21 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ *	Iterative ear clipping of a spline area,used to create covers.
+ *	Points are in local space of spline to sweep,the area lies in YZ plane.
+ *	Vertices are kept in a linked list and ears in a queue,only the two neighbours of a clipped ear are tested again.
+ *	An ear test checks reflex vertices only,so a profile of n points with r reflex vertices is triangulated in O(n*r) without recursion.
+ */
+struct SPLINESWEEPMESH_API FSplineSweepTriangulator
+{
+	/**
+	 *	Triangulate a simple polygon
+	 *	@param	Points			Outline of the area,either winding
+	 *	@param	OutIndices		Receives three indices into Points per triangle,all wound so that Cross(B - A, C - A) points to -X
+	 *	@return	Number of triangles created
+	 */
+	static int Triangulate(const TArray<FVector>& Points, TArray<int>& OutIndices);
+};
@@ -0,0 +1,88 @@
+// Copyright 2022 Sun Boheng.All Rights Reserved.
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "SplineSweepUpdateSubsystem.generated.h"
+
+class USplineComponent;
+class USplineSweepMeshComponent;
+
+/**
+ *	Schedules UpdatePathSpline of sweep components within a time budget per frame.
+ *	Requests for the same component are merged,only the latest path and rate are built.
+ *	Pending updates run by priority: recently rendered,close to a view and waiting long go first.
+ *	Components not rendered recently are deferred until they are rendered again or waited MaxDeferSeconds.
+ *	Budgets are read from [/Script/SplineSweepMesh.SplineSweepUpdateSubsystem] of Engine config when the world starts.
+ */
+UCLASS(config = Engine)
+class SPLINESWEEPMESH_API USplineSweepUpdateSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+public:
+	/**
+	 *	Queue an update of a sweep component,replacing the one it has pending
+	 *	@param	Component		Component to update
+	 *	@param	Path			A spline component reference which is used as path
+	 *	@param	RateOfProgress	To make grow animation.Rate of grow progress along path
+	 */
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void RequestUpdate(USplineSweepMeshComponent* Component, USplineComponent* Path, float RateOfProgress);
+	//Drop the pending update of a component
+	UFUNCTION(BlueprintCallable, Category = "SplineSweep")
+		void CancelUpdate(USplineSweepMeshComponent* Component);
+
+	//Number of components waiting for an update
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetQueueDepth() const { return Pending.Num(); }
+	//Updates skipped last frame because their component was not rendered recently
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumDeferredLastFrame() const { return NumDeferredLastFrame; }
+	//Updates left for a later frame last frame because the budget was spent
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumOverBudgetLastFrame() const { return NumOverBudgetLastFrame; }
+	//Updates run last frame
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumProcessedLastFrame() const { return NumProcessedLastFrame; }
+	//Requests merged into one already pending since the world started
+	UFUNCTION(BlueprintPure, Category = "SplineSweep")
+		int GetNumCollapsedRequests() const { return NumCollapsedRequests; }
+
+	//Time in milliseconds spent on updates per frame.At least one update runs every frame
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		float BudgetMilliseconds = 2;
+	//Components rendered within this many seconds count as visible
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		float RecentlyRenderedSeconds = 0.2f;
+	//Longest time an update of a component that is not rendered waits
+	UPROPERTY(Config, EditAnywhere, BlueprintReadWrite, Category = "SplineSweep")
+		float MaxDeferSeconds = 2;
+
+	//FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return Pending.Num() > 0; }
+	virtual bool IsTickableInEditor() const override { return true; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+
+protected:
+	struct FRequest
+	{
+		TWeakObjectPtr<USplineComponent> Path;
+		float Rate = 1;
+		//Time of the first request since the last update,staleness grows from it
+		double RequestTime = 0;
+		//Sort key,computed every frame
+		float Priority = 0;
+	};
+
+	TMap<TWeakObjectPtr<USplineSweepMeshComponent>, FRequest> Pending;
+	int NumDeferredLastFrame = 0;
+	int NumOverBudgetLastFrame = 0;
+	int NumProcessedLastFrame = 0;
+	int NumCollapsedRequests = 0;
+
+	//Higher runs first.Negative if the update is deferred this frame
+	float ComputePriority(const USplineSweepMeshComponent& Component, const FRequest& Request, double Now) const;
+};
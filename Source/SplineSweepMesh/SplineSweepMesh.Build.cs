@@ -38,7 +38,11 @@ public class SplineSweepMesh : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
-				"ProceduralMeshComponent"
+				"ProceduralMeshComponent",
+				"Json",
+				"Projects",
+				"RenderCore",
+				"RHI"
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);